@@ -1,4 +1,4 @@
 cd src
-g++ -o main.exe main.cpp SpotifyDataset.cpp StatDesc.cpp Artist.cpp StatInfer.cpp
+g++ -o main.exe main.cpp SpotifyDataset.cpp MappedFile.cpp ThreadPool.cpp Kernels.cpp Parallel.cpp Attribute.cpp OnlineStats.cpp StatDesc.cpp Artist.cpp StatInfer.cpp Resampling.cpp QueryCache.cpp QueryServer.cpp DatasetHolder.cpp StringPool.cpp Expression.cpp Query.cpp
 main.exe
 pause
\ No newline at end of file
@@ -0,0 +1,7 @@
+#!/bin/sh
+# Build Linux : main + client du mode serveur (--serve, Linux uniquement).
+# Sous Windows, utiliser MakeFile.bat (sans serveur ni client).
+cd "$(dirname "$0")/src" || exit 1
+g++ -std=c++17 -O2 -pthread -o main main.cpp SpotifyDataset.cpp MappedFile.cpp ThreadPool.cpp Kernels.cpp Parallel.cpp Attribute.cpp OnlineStats.cpp StatDesc.cpp Artist.cpp StatInfer.cpp Resampling.cpp QueryCache.cpp QueryServer.cpp DatasetHolder.cpp StringPool.cpp Expression.cpp Query.cpp || exit 1
+g++ -std=c++17 -O2 -o client client.cpp || exit 1
+./main
@@ -1,12 +1,12 @@
 #include "Artist.h"
 
 // Constructeur : affectation des membres via liste d'initialisation
-Artist::Artist(const std::string& name, double streams, double daily, double asLead, double solo, double asFeature)
-    : name(name), streams(streams), daily(daily), asLead(asLead), solo(solo), asFeature(asFeature) {}
+Artist::Artist(uint32_t nameId, double streams, double daily, double asLead, double solo, double asFeature)
+    : nameId(nameId), streams(streams), daily(daily), asLead(asLead), solo(solo), asFeature(asFeature) {}
 
 // Getters : renvoient les valeurs stockées
-const std::string& Artist::getName() const {
-    return name;
+uint32_t Artist::getNameId() const {
+    return nameId;
 }
 
 double Artist::getStreams() const {
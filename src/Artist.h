@@ -1,11 +1,15 @@
 #pragma once
-#include <string>
+#include <cstdint>
+#include <type_traits>
 
 /*
   Représente un artiste Spotify et ses métriques agrégées.
 
+  Enregistrement compact et trivialement copiable : le nom n'est pas stocké, seulement
+  son id dans le pool de noms du dataset (SpotifyDataset::nameOf(getNameId())).
+
   Champs (tous en double pour rester cohérent avec les valeurs décimales du CSV) :
-    - name       : nom de l'artiste
+    - nameId     : id du nom de l'artiste (StringPool du dataset)
     - streams    : total de streams
     - daily      : score journalier
     - asLead     : streams en tant qu'artiste principal (lead)
@@ -14,7 +18,7 @@
 */
 class Artist {
 private:
-    std::string name;
+    uint32_t nameId;
     double streams;
     double daily;
     double asLead;
@@ -22,14 +26,17 @@ private:
     double asFeature;
 
 public:
+    Artist() = default;
     // Constructeur : initialise tous les champs
-    Artist(const std::string& name, double streams, double daily, double asLead, double solo, double asFeature);
+    Artist(uint32_t nameId, double streams, double daily, double asLead, double solo, double asFeature);
 
     // Getters (accesseurs en lecture uniquement)
-    const std::string& getName() const;
+    uint32_t getNameId() const;
     double getStreams() const;
     double getDaily() const;
     double getAsLead() const;
     double getSolo() const;
     double getAsFeature() const;
 };
+
+static_assert(std::is_trivially_copyable<Artist>::value, "Artist doit rester copiable par memcpy");
@@ -0,0 +1,26 @@
+#include "Attribute.h"
+
+bool parseAttribute(const std::string& name, Attribute& out) {
+    if      (name == "streams")                             out = Attribute::Streams;
+    else if (name == "daily")                               out = Attribute::Daily;
+    else if (name == "aslead" || name == "as_lead")         out = Attribute::AsLead;
+    else if (name == "solo")                                out = Attribute::Solo;
+    else if (name == "asfeature" || name == "as_feature")   out = Attribute::AsFeature;
+    else return false;
+    return true;
+}
+
+const char* attributeName(Attribute attr) {
+    switch (attr) {
+        case Attribute::Streams:   return "streams";
+        case Attribute::Daily:     return "daily";
+        case Attribute::AsLead:    return "aslead";
+        case Attribute::Solo:      return "solo";
+        case Attribute::AsFeature: return "asfeature";
+    }
+    return "";
+}
+
+const char* attributeList() {
+    return "streams, daily, aslead, solo, asfeature";
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+
+/*
+  Attribute : métrique numérique d'un artiste, résolue une fois depuis son nom
+  à l'entrée d'une commande, puis passée telle quelle aux API StatDesc/StatInfer
+  (plus de comparaison de chaînes dans les boucles).
+*/
+enum class Attribute {
+    Streams = 0,
+    Daily,
+    AsLead,
+    Solo,
+    AsFeature
+};
+
+constexpr int NB_ATTRIBUTES = 5;
+
+// "streams", "daily", "aslead"/"as_lead", "solo", "asfeature"/"as_feature".
+// Renvoie false (out inchangé) si le nom est inconnu.
+bool parseAttribute(const std::string& name, Attribute& out);
+
+// Nom canonique ("streams", "daily", "aslead", "solo", "asfeature")
+const char* attributeName(Attribute attr);
+
+// Liste des noms acceptés, pour les messages d'erreur
+const char* attributeList();
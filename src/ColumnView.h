@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+/*
+  ColumnView : vue en lecture seule (pointeur + taille) sur une colonne de doubles contigus.
+
+  Ne possède pas les données : la vue reste valide tant que la colonne source
+  (colonne du SpotifyDataset ou std::vector<double>) n'est ni modifiée ni détruite.
+  Construction implicite depuis un std::vector<double> pour garder les appels existants.
+*/
+class ColumnView {
+private:
+    const double* ptr;
+    size_t n;
+
+public:
+    ColumnView() : ptr(nullptr), n(0) {}
+    ColumnView(const double* data, size_t size) : ptr(data), n(size) {}
+    ColumnView(const std::vector<double>& v) : ptr(v.data()), n(v.size()) {}
+
+    const double* data() const { return ptr; }
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    const double* begin() const { return ptr; }
+    const double* end() const { return ptr + n; }
+
+    double operator[](size_t i) const { return ptr[i]; }
+
+    // Copie explicite quand un algorithme doit modifier les valeurs (ex: tri)
+    std::vector<double> toVector() const { return std::vector<double>(ptr, ptr + n); }
+};
@@ -0,0 +1,153 @@
+#include "DatasetHolder.h"
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+DatasetHolder::DatasetHolder(const std::string& source, const std::string& log)
+    : published(std::make_shared<const SpotifyDataset>()), sourceFile(source), logFile(log) {}
+
+DatasetHolder::~DatasetHolder() {
+    {
+        std::lock_guard<std::mutex> lock(watchMtx);
+        stopWatch = true;
+    }
+    watchCv.notify_all();
+    if (watchThread.joinable()) watchThread.join();
+    if (reloadThread.joinable()) reloadThread.join();
+}
+
+DatasetHolder::Snapshot DatasetHolder::current() const {
+    return std::atomic_load(&published);
+}
+
+std::string DatasetHolder::source() const {
+    std::lock_guard<std::mutex> lock(stateMtx);
+    return sourceFile;
+}
+
+// Construction hors ligne puis publication : les requêtes en cours gardent leur
+// propre shared_ptr sur l'ancienne version, aucune attente de part et d'autre.
+bool DatasetHolder::doReload(const std::string& file, std::string& message) {
+    std::string path = file.empty() ? source() : file;
+    auto fresh = std::make_shared<SpotifyDataset>();
+    std::ostringstream log;
+    bool ok = fresh->load(path, log);
+    if (!ok) log << "Erreur lors de l'ouverture du CSV " << path << "\n";
+
+    std::ostringstream oss;
+    if (ok) {
+        oss << "Dataset charge depuis " << path << " : " << fresh->size() << " artistes.\n";
+        std::atomic_store(&published, Snapshot(std::move(fresh)));
+    } else {
+        oss << "Echec du rechargement de " << path << " : version precedente conservee.\n";
+    }
+    message = oss.str();
+
+    std::lock_guard<std::mutex> lock(stateMtx);
+    if (ok) sourceFile = path;
+    std::ofstream out(logFile, std::ios::app);
+    out << log.str() << message;
+    return ok;
+}
+
+bool DatasetHolder::reload(const std::string& file, std::string& message) {
+    if (reloading.exchange(true)) {
+        message = "Rechargement deja en cours.\n";
+        return false;
+    }
+    bool ok = doReload(file, message);
+    reloading = false;
+    return ok;
+}
+
+// La copie de la version courante est faite à part : les lecteurs continuent sur
+// l'original, qui n'est jamais modifié.
+bool DatasetHolder::upsert(const std::string& file, std::string& message) {
+    if (reloading.exchange(true)) {
+        message = "Rechargement deja en cours.\n";
+        return false;
+    }
+    auto next = std::make_shared<SpotifyDataset>(*current());
+    std::ostringstream log;
+    SpotifyDataset::UpsertStats stats;
+    bool ok = next->upsertFromCSV(file, log, stats);
+
+    std::ostringstream oss;
+    if (ok) {
+        oss << "Ajout depuis " << file << " : " << stats.inserted << " artiste(s) ajoute(s), "
+            << stats.updated << " mis a jour. Total artistes: " << next->size() << "\n";
+        std::atomic_store(&published, Snapshot(std::move(next)));
+    } else {
+        oss << "Impossible d'ouvrir " << file << " : version courante conservee.\n";
+    }
+    message = oss.str();
+    {
+        std::lock_guard<std::mutex> lock(stateMtx);
+        std::ofstream out(logFile, std::ios::app);
+        out << log.str() << message;
+    }
+    reloading = false;
+    return ok;
+}
+
+bool DatasetHolder::reloadAsync(const std::string& file) {
+    if (reloading.exchange(true)) return false;
+    if (reloadThread.joinable()) reloadThread.join(); // rechargement précédent, déjà terminé
+    reloadThread = std::thread([this, file] {
+        std::string message;
+        doReload(file, message);
+        addNotice(message);
+        reloading = false;
+    });
+    return true;
+}
+
+// Même exclusion que reload : le rechargement en arrière-plan et la surveillance
+// attendent (ou sautent un tour) pendant fn.
+bool DatasetHolder::runExclusive(const std::function<void()>& fn) {
+    if (reloading.exchange(true)) return false;
+    try {
+        fn();
+    } catch (...) {
+        reloading = false;
+        throw;
+    }
+    reloading = false;
+    return true;
+}
+
+void DatasetHolder::addNotice(const std::string& message) {
+    std::lock_guard<std::mutex> lock(stateMtx);
+    notices += message;
+}
+
+std::string DatasetHolder::takeNotices() {
+    std::lock_guard<std::mutex> lock(stateMtx);
+    std::string out;
+    out.swap(notices);
+    return out;
+}
+
+void DatasetHolder::startWatch(std::chrono::milliseconds period) {
+    if (watchThread.joinable()) return;
+    watchThread = std::thread([this, period] { watchLoop(period); });
+}
+
+// Scrutation périodique de la date de modification (portable, pas d'inotify) ;
+// un fichier en cours d'écriture est rechargé à nouveau au tour suivant s'il change encore.
+void DatasetHolder::watchLoop(std::chrono::milliseconds period) {
+    std::error_code ec;
+    std::filesystem::file_time_type seen = std::filesystem::last_write_time(source(), ec);
+    std::unique_lock<std::mutex> lock(watchMtx);
+    while (!watchCv.wait_for(lock, period, [this] { return stopWatch; })) {
+        std::filesystem::file_time_type now = std::filesystem::last_write_time(source(), ec);
+        if (ec || now == seen) continue;
+        if (reloading.exchange(true)) continue; // rechargement manuel en cours : tour suivant
+        lock.unlock();
+        std::string message;
+        if (doReload("", message)) seen = now;
+        reloading = false;
+        addNotice(message);
+        lock.lock();
+    }
+}
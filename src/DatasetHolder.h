@@ -0,0 +1,85 @@
+#pragma once
+#include "SpotifyDataset.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+/*
+  DatasetHolder : version courante du dataset, remplaçable à chaud.
+
+  Chaque version est un SpotifyDataset immuable partagé par std::shared_ptr.
+  current() renvoie la version publiée ; une requête garde ce pointeur jusqu'à
+  la fin, donc elle travaille sur un état cohérent même si un rechargement
+  publie une nouvelle version entre-temps. L'ancienne version est libérée
+  quand la dernière requête qui l'utilise se termine.
+
+  Un rechargement construit la nouvelle version à part (snapshot binaire ou
+  CSV, voir SpotifyDataset::load) puis la publie d'un seul échange atomique :
+  les lecteurs ne sont jamais bloqués. En cas d'échec, la version courante
+  reste en place. Un seul rechargement (ou upsert) à la fois.
+  Les diagnostics de chargement sont ajoutés au fichier 'logFile'.
+*/
+class DatasetHolder {
+public:
+    using Snapshot = std::shared_ptr<const SpotifyDataset>;
+
+    DatasetHolder(const std::string& source, const std::string& logFile);
+    ~DatasetHolder();
+
+    DatasetHolder(const DatasetHolder&) = delete;
+    DatasetHolder& operator=(const DatasetHolder&) = delete;
+
+    // Version publiée (jamais nulle : dataset vide avant le premier chargement)
+    Snapshot current() const;
+
+    // Fichier CSV de la version courante
+    std::string source() const;
+
+    // Recharge depuis 'file' (vide = source actuelle) et publie ; bloquant.
+    // 'message' décrit le résultat. false si le fichier ne s'ouvre pas ou si
+    // un autre rechargement est en cours.
+    bool reload(const std::string& file, std::string& message);
+
+    // Même chose en arrière-plan ; le message final est récupéré par takeNotices().
+    // false (rien n'est lancé) si un rechargement est déjà en cours.
+    bool reloadAsync(const std::string& file);
+
+    // Nouvelle version = copie de la version courante + lignes de 'file' ajoutées ou
+    // mises à jour par nom (SpotifyDataset::upsertFromCSV) ; bloquant, même exclusion
+    // que reload. Les agrégats sont recalculés une fois à la fin du lot.
+    bool upsert(const std::string& file, std::string& message);
+
+    // Exécute fn sans rechargement ni upsert concurrent (ex : "threads N", qui remplace
+    // le pool global utilisé par le chargement parallèle). false, sans appeler fn,
+    // si un rechargement est en cours.
+    bool runExclusive(const std::function<void()>& fn);
+
+    // Surveille la date de modification de la source et recharge quand elle change
+    void startWatch(std::chrono::milliseconds period);
+
+    // Messages des rechargements faits en arrière-plan depuis le dernier appel
+    std::string takeNotices();
+
+private:
+    Snapshot published;            // lu/écrit par std::atomic_load / std::atomic_store
+    std::string sourceFile;
+    std::string logFile;
+    std::string notices;
+    mutable std::mutex stateMtx;   // sourceFile, notices, écriture du log
+    std::atomic<bool> reloading{false};
+
+    std::thread reloadThread;
+    std::thread watchThread;
+    std::mutex watchMtx;
+    std::condition_variable watchCv;
+    bool stopWatch = false;
+
+    bool doReload(const std::string& file, std::string& message); // 'reloading' déjà pris
+    void addNotice(const std::string& message);
+    void watchLoop(std::chrono::milliseconds period);
+};
@@ -0,0 +1,331 @@
+#include "Expression.h"
+#include "SpotifyDataset.h"
+#include "Parallel.h"
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+// ----------- Lexer -----------
+
+bool Expression::tokenize(const std::string& text, std::vector<Token>& out, std::string& error) {
+    out.clear();
+    size_t i = 0, n = text.size();
+    while (i < n) {
+        unsigned char c = (unsigned char)text[i];
+        if (std::isspace(c)) { ++i; continue; }
+        Token tok;
+        if (std::isdigit(c) || (c == '.' && i + 1 < n && std::isdigit((unsigned char)text[i+1]))) {
+            const char* begin = text.c_str() + i;
+            char* end = nullptr;
+            tok.kind = Token::Number;
+            tok.value = std::strtod(begin, &end);
+            tok.text.assign(begin, (size_t)(end - begin));
+            i += (size_t)(end - begin);
+        } else if (std::isalpha(c) || c == '_') {
+            tok.kind = Token::Name;
+            while (i < n && (std::isalnum((unsigned char)text[i]) || text[i] == '_'))
+                tok.text.push_back((char)std::tolower((unsigned char)text[i++]));
+        } else if (c == '(') { tok.kind = Token::LParen; tok.text = "("; ++i; }
+        else if (c == ')') { tok.kind = Token::RParen; tok.text = ")"; ++i; }
+        else if (c == ',') { tok.kind = Token::Comma; tok.text = ","; ++i; }
+        else if (c == '+' || c == '-' || c == '*' || c == '/') { tok.kind = Token::Op; tok.text = std::string(1, (char)c); ++i; }
+        else if (c == '<' || c == '>' || c == '=' || c == '!') {
+            tok.kind = Token::Op;
+            tok.text = std::string(1, (char)c);
+            ++i;
+            if (i < n && text[i] == '=') { tok.text.push_back('='); ++i; }
+            if (tok.text == "=") tok.text = "==";
+            if (tok.text == "!") { error = "operateur inconnu : !"; return false; }
+        } else {
+            error = std::string("caractere inattendu : ") + (char)c;
+            return false;
+        }
+        out.push_back(tok);
+    }
+    Token end;
+    end.kind = Token::End;
+    out.push_back(end);
+    return true;
+}
+
+// ----------- Compilation -----------
+
+bool Expression::compile(const std::string& text, std::string& error) {
+    std::vector<Token> tokens;
+    if (!tokenize(text, tokens, error)) return false;
+    size_t pos = 0;
+    if (!compile(tokens, pos, error)) return false;
+    if (tokens[pos].kind != Token::End) {
+        error = "fin d'expression attendue avant : " + tokens[pos].text;
+        return false;
+    }
+    return true;
+}
+
+bool Expression::compile(const std::vector<Token>& tokens, size_t& pos, std::string& error) {
+    program.clear();
+    size_t start = pos;
+    if (!parseExpr(tokens, pos, error)) return false;
+    source.clear();
+    for (size_t i = start; i < pos; ++i) source += tokens[i].text;
+    computeDepth();
+    return true;
+}
+
+bool Expression::parseExpr(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    if (!parseTerm(t, pos, error)) return false;
+    while (t[pos].kind == Token::Op && (t[pos].text == "+" || t[pos].text == "-")) {
+        OpCode op = (t[pos++].text == "+") ? OpCode::Add : OpCode::Sub;
+        if (!parseTerm(t, pos, error)) return false;
+        emit({op});
+    }
+    return true;
+}
+
+bool Expression::parseTerm(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    if (!parseUnary(t, pos, error)) return false;
+    while (t[pos].kind == Token::Op && (t[pos].text == "*" || t[pos].text == "/")) {
+        OpCode op = (t[pos++].text == "*") ? OpCode::Mul : OpCode::Div;
+        if (!parseUnary(t, pos, error)) return false;
+        emit({op});
+    }
+    return true;
+}
+
+bool Expression::parseUnary(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    if (t[pos].kind == Token::Op && t[pos].text == "-") {
+        ++pos;
+        if (!parseUnary(t, pos, error)) return false;
+        emit({OpCode::Neg});
+        return true;
+    }
+    return parsePrimary(t, pos, error);
+}
+
+bool Expression::parsePrimary(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    const Token& tok = t[pos];
+    if (tok.kind == Token::Number) {
+        ++pos;
+        Instr in{OpCode::Constant};
+        in.value = tok.value;
+        emit(in);
+        return true;
+    }
+    if (tok.kind == Token::Name && t[pos+1].kind == Token::LParen)
+        return parseCall(t, pos, error);
+    if (tok.kind == Token::Name) {
+        Attribute attr;
+        if (!parseAttribute(tok.text, attr)) {
+            error = "colonne inconnue : " + tok.text + " (attendu : " + attributeList() + ")";
+            return false;
+        }
+        ++pos;
+        Instr in{OpCode::Column};
+        in.attr = attr;
+        emit(in);
+        return true;
+    }
+    if (tok.kind == Token::LParen) {
+        ++pos;
+        if (!parseExpr(t, pos, error)) return false;
+        if (t[pos].kind != Token::RParen) {
+            error = "')' attendue";
+            return false;
+        }
+        ++pos;
+        return true;
+    }
+    error = (tok.kind == Token::End) ? "expression incomplete" : "terme attendu avant : " + tok.text;
+    return false;
+}
+
+// fonction '(' expr [',' expr] ')' : le nombre d'arguments est vérifié ici
+bool Expression::parseCall(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    static const struct { const char* name; OpCode op; } FUNCS[] = {
+        {"abs", OpCode::Abs}, {"sqrt", OpCode::Sqrt}, {"log", OpCode::Log}, {"exp", OpCode::Exp},
+        {"min", OpCode::Min}, {"max", OpCode::Max}, {"pow", OpCode::Pow}
+    };
+    const std::string& name = t[pos].text;
+    OpCode op = OpCode::Abs;
+    bool known = false;
+    for (const auto& f : FUNCS)
+        if (name == f.name) { op = f.op; known = true; }
+    if (!known) {
+        error = "fonction inconnue : " + name + " (attendu : abs, sqrt, log, exp, min, max, pow)";
+        return false;
+    }
+    pos += 2;
+    if (!parseExpr(t, pos, error)) return false;
+    if (isBinary(op)) {
+        if (t[pos].kind != Token::Comma) { error = name + " attend deux arguments"; return false; }
+        ++pos;
+        if (!parseExpr(t, pos, error)) return false;
+    }
+    if (t[pos].kind != Token::RParen) {
+        error = (t[pos].kind == Token::Comma) ? name + " attend un seul argument" : "')' attendue apres " + name;
+        return false;
+    }
+    ++pos;
+    emit({op});
+    return true;
+}
+
+double Expression::apply(OpCode op, double a, double b) {
+    switch (op) {
+        case OpCode::Neg:  return -a;
+        case OpCode::Abs:  return std::fabs(a);
+        case OpCode::Sqrt: return std::sqrt(a);
+        case OpCode::Log:  return std::log(a);
+        case OpCode::Exp:  return std::exp(a);
+        case OpCode::Add:  return a + b;
+        case OpCode::Sub:  return a - b;
+        case OpCode::Mul:  return a * b;
+        case OpCode::Div:  return a / b;
+        case OpCode::Min:  return std::fmin(a, b);
+        case OpCode::Max:  return std::fmax(a, b);
+        case OpCode::Pow:  return std::pow(a, b);
+        default:           return 0.0;
+    }
+}
+
+// Repli des constantes à la compilation : "-2", "1/1000", "log(10)" ne coûtent rien par lot
+void Expression::emit(const Instr& instr) {
+    size_t n = program.size();
+    if (isUnary(instr.op) && n >= 1 && program[n-1].op == OpCode::Constant) {
+        program[n-1].value = apply(instr.op, program[n-1].value);
+        return;
+    }
+    if (isBinary(instr.op) && n >= 2 && program[n-2].op == OpCode::Constant && program[n-1].op == OpCode::Constant) {
+        double r = apply(instr.op, program[n-2].value, program[n-1].value);
+        program.pop_back();
+        program.back().value = r;
+        return;
+    }
+    program.push_back(instr);
+}
+
+void Expression::computeDepth() {
+    size_t depth = 0;
+    maxDepth = 1;
+    for (const Instr& in : program) {
+        if (in.op == OpCode::Column || in.op == OpCode::Constant) depth++;
+        else if (isBinary(in.op)) depth--;
+        if (depth > maxDepth) maxDepth = depth;
+    }
+}
+
+bool Expression::isColumn(Attribute& attr) const {
+    if (program.size() != 1 || program[0].op != OpCode::Column) return false;
+    attr = program[0].attr;
+    return true;
+}
+
+// ----------- Évaluation par lots -----------
+
+namespace {
+
+// Opérande : vecteur (p[0..count)) ou scalaire (constante repliée)
+struct Operand {
+    const double* p = nullptr;
+    bool scalar = false;
+    double v = 0.0;
+};
+
+// out[i] = f(a[i], b[i]) avec les 4 combinaisons vecteur/scalaire déroulées
+// une fois par lot : la boucle interne ne teste rien.
+template <class F>
+void binaryLoop(const Operand& a, const Operand& b, double* out, size_t count, F f) {
+    if (!a.scalar && !b.scalar)     for (size_t i = 0; i < count; ++i) out[i] = f(a.p[i], b.p[i]);
+    else if (!a.scalar)             for (size_t i = 0; i < count; ++i) out[i] = f(a.p[i], b.v);
+    else                            for (size_t i = 0; i < count; ++i) out[i] = f(a.v, b.p[i]);
+}
+
+// out[i] = f(a[i]) ; l'opérande est toujours un vecteur (constantes repliées)
+template <class F>
+void unaryLoop(const double* a, double* out, size_t count, F f) {
+    for (size_t i = 0; i < count; ++i) out[i] = f(a[i]);
+}
+
+} // namespace
+
+const double* Expression::evaluate(const SpotifyDataset& data, size_t begin, size_t count, std::vector<double>& work) const {
+    if (work.size() < maxDepth * BATCH) work.resize(maxDepth * BATCH);
+    Operand stackBuf[16];
+    std::vector<Operand> heapStack;
+    Operand* stack = stackBuf;
+    if (maxDepth > 16) { heapStack.resize(maxDepth); stack = heapStack.data(); }
+
+    size_t d = 0;
+    for (const Instr& in : program) {
+        switch (in.op) {
+            case OpCode::Column:
+                stack[d].p = data.getAttribute(in.attr).data() + begin;
+                stack[d].scalar = false;
+                d++;
+                break;
+            case OpCode::Constant:
+                stack[d].scalar = true;
+                stack[d].v = in.value;
+                d++;
+                break;
+            case OpCode::Neg:
+            case OpCode::Abs:
+            case OpCode::Sqrt:
+            case OpCode::Log:
+            case OpCode::Exp: {
+                Operand& a = stack[d-1];
+                double* out = work.data() + (d-1) * BATCH;
+                switch (in.op) {
+                    case OpCode::Neg:  unaryLoop(a.p, out, count, [](double x) { return -x; }); break;
+                    case OpCode::Abs:  unaryLoop(a.p, out, count, [](double x) { return std::fabs(x); }); break;
+                    case OpCode::Sqrt: unaryLoop(a.p, out, count, [](double x) { return std::sqrt(x); }); break;
+                    case OpCode::Log:  unaryLoop(a.p, out, count, [](double x) { return std::log(x); }); break;
+                    default:           unaryLoop(a.p, out, count, [](double x) { return std::exp(x); }); break;
+                }
+                a.p = out;
+                break;
+            }
+            default: {
+                Operand& a = stack[d-2];
+                const Operand& b = stack[d-1];
+                double* out = work.data() + (d-2) * BATCH;
+                switch (in.op) {
+                    case OpCode::Add: binaryLoop(a, b, out, count, [](double x, double y) { return x + y; }); break;
+                    case OpCode::Sub: binaryLoop(a, b, out, count, [](double x, double y) { return x - y; }); break;
+                    case OpCode::Mul: binaryLoop(a, b, out, count, [](double x, double y) { return x * y; }); break;
+                    case OpCode::Div: binaryLoop(a, b, out, count, [](double x, double y) { return x / y; }); break;
+                    case OpCode::Min: binaryLoop(a, b, out, count, [](double x, double y) { return std::fmin(x, y); }); break;
+                    case OpCode::Max: binaryLoop(a, b, out, count, [](double x, double y) { return std::fmax(x, y); }); break;
+                    default:          binaryLoop(a, b, out, count, [](double x, double y) { return std::pow(x, y); }); break;
+                }
+                a.p = out;
+                a.scalar = false;
+                d--;
+                break;
+            }
+        }
+    }
+    // Expression constante : diffusée sur le lot
+    if (stack[0].scalar) {
+        for (size_t i = 0; i < count; ++i) work[i] = stack[0].v;
+        return work.data();
+    }
+    return stack[0].p;
+}
+
+// Chaque morceau écrit sa propre plage de 'out' avec son propre tampon de travail
+std::vector<double> Expression::evaluateAll(const SpotifyDataset& data) const {
+    size_t n = data.size();
+    std::vector<double> out(n);
+    ThreadPool::global().parallelFor(Parallel::nbChunks(n), [&](size_t c) {
+        size_t end = std::min(n, (c + 1) * Parallel::CHUNK);
+        std::vector<double> work;
+        for (size_t begin = c * Parallel::CHUNK; begin < end; begin += BATCH) {
+            size_t count = std::min(BATCH, end - begin);
+            const double* v = evaluate(data, begin, count, work);
+            std::copy(v, v + count, out.begin() + begin);
+        }
+    });
+    return out;
+}
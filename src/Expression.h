@@ -0,0 +1,87 @@
+#pragma once
+#include "Attribute.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+class SpotifyDataset;
+
+/*
+  Expression : métrique dérivée des colonnes ("solo/streams", "abs(aslead-asfeature)",
+  "log(streams)").
+
+  Opérateurs + - * / et parenthèses ; fonctions abs, sqrt, log (népérien), exp,
+  min(a, b), max(a, b), pow(a, b).
+
+  Le texte est analysé une fois et compilé en programme postfixé (colonnes,
+  constantes, opérateurs). L'évaluation se fait par lots de BATCH lignes : chaque
+  instruction parcourt tout le lot dans une boucle serrée, l'interprétation ne
+  coûte qu'une fois par lot et non par ligne. Les colonnes sont lues en place ;
+  seuls les résultats intermédiaires utilisent le tampon de travail de l'appelant
+  (un par thread : evaluate est const et ne partage rien).
+
+  Arithmétique IEEE : une division par zéro donne inf ou NaN, à l'appelant de
+  filtrer (voir Query).
+*/
+class Expression {
+public:
+    static constexpr size_t BATCH = 1024;
+
+    // Lexème, partagé avec le parseur de requêtes (Query)
+    struct Token {
+        enum Kind { Number, Name, Op, LParen, RParen, Comma, End };
+        Kind kind = End;
+        std::string text;   // nom en minuscules, ou opérateur (+ - * / < <= > >= == !=)
+        double value = 0.0; // Number
+    };
+    // Découpe 'text' ; false + message si un caractère n'est pas reconnu
+    static bool tokenize(const std::string& text, std::vector<Token>& out, std::string& error);
+
+    // Compile l'expression entière 'text'
+    bool compile(const std::string& text, std::string& error);
+    // Compile l'expression qui commence à tokens[pos] et avance pos jusqu'au premier
+    // lexème qui ne la prolonge pas (utilisé pour les expressions d'une requête)
+    bool compile(const std::vector<Token>& tokens, size_t& pos, std::string& error);
+
+    // Valeurs des lignes [begin, begin+count), count <= BATCH. Le pointeur renvoyé
+    // désigne la colonne elle-même ou 'work' ; valide jusqu'au prochain appel avec 'work'.
+    const double* evaluate(const SpotifyDataset& data, size_t begin, size_t count, std::vector<double>& work) const;
+
+    // Évaluation de toutes les lignes (lots successifs, morceaux en parallèle)
+    std::vector<double> evaluateAll(const SpotifyDataset& data) const;
+
+    // Texte normalisé (sans espaces), pour les libellés
+    const std::string& text() const { return source; }
+
+    // true si l'expression est une colonne seule (attr rempli)
+    bool isColumn(Attribute& attr) const;
+
+private:
+    enum class OpCode {
+        Column, Constant,
+        Neg, Abs, Sqrt, Log, Exp,     // unaires
+        Add, Sub, Mul, Div, Min, Max, Pow // binaires
+    };
+    struct Instr {
+        OpCode op;
+        Attribute attr = Attribute::Streams; // Column
+        double value = 0.0;                  // Constant
+    };
+    std::vector<Instr> program; // postfixé
+    size_t maxDepth = 0;        // profondeur de pile maximale
+    std::string source;
+
+    // Descente récursive : expr := term (('+'|'-') term)* ; term := unary (('*'|'/') unary)*
+    // unary := '-' unary | primary
+    // primary := nombre | colonne | fonction '(' expr [',' expr] ')' | '(' expr ')'
+    bool parseExpr(const std::vector<Token>& t, size_t& pos, std::string& error);
+    bool parseTerm(const std::vector<Token>& t, size_t& pos, std::string& error);
+    bool parseUnary(const std::vector<Token>& t, size_t& pos, std::string& error);
+    bool parsePrimary(const std::vector<Token>& t, size_t& pos, std::string& error);
+    bool parseCall(const std::vector<Token>& t, size_t& pos, std::string& error);
+    static bool isUnary(OpCode op) { return op >= OpCode::Neg && op <= OpCode::Exp; }
+    static bool isBinary(OpCode op) { return op >= OpCode::Add; }
+    static double apply(OpCode op, double a, double b = 0.0); // repli des constantes
+    void emit(const Instr& instr);
+    void computeDepth();
+};
@@ -0,0 +1,322 @@
+#include "Kernels.h"
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// ----------- Versions scalaires (4 accumulateurs) -----------
+
+namespace {
+
+double sumScalar(const double* x, size_t n) {
+    double a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) { a0 += x[i]; a1 += x[i+1]; a2 += x[i+2]; a3 += x[i+3]; }
+    for (; i < n; ++i) a0 += x[i];
+    return (a0 + a1) + (a2 + a3);
+}
+
+double sumSqDevScalar(const double* x, size_t n, double m) {
+    double a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        double d0 = x[i]-m, d1 = x[i+1]-m, d2 = x[i+2]-m, d3 = x[i+3]-m;
+        a0 += d0*d0; a1 += d1*d1; a2 += d2*d2; a3 += d3*d3;
+    }
+    for (; i < n; ++i) { double d = x[i]-m; a0 += d*d; }
+    return (a0 + a1) + (a2 + a3);
+}
+
+Kernels::CrossDev crossDevScalar(const double* x, const double* y, size_t n, double mx, double my) {
+    double xx[2] = {0, 0}, yy[2] = {0, 0}, xy[2] = {0, 0};
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        for (int k = 0; k < 2; ++k) {
+            double dx = x[i+k]-mx, dy = y[i+k]-my;
+            xx[k] += dx*dx; yy[k] += dy*dy; xy[k] += dx*dy;
+        }
+    }
+    for (; i < n; ++i) {
+        double dx = x[i]-mx, dy = y[i]-my;
+        xx[0] += dx*dx; yy[0] += dy*dy; xy[0] += dx*dy;
+    }
+    Kernels::CrossDev r;
+    r.sxx = xx[0] + xx[1]; r.syy = yy[0] + yy[1]; r.sxy = xy[0] + xy[1];
+    return r;
+}
+
+void minMaxScalar(const double* x, size_t n, double& mn, double& mx) {
+    if (n == 0) return;
+    double lo = x[0], hi = x[0];
+    for (size_t i = 1; i < n; ++i) {
+        if (x[i] < lo) lo = x[i];
+        if (x[i] > hi) hi = x[i];
+    }
+    mn = lo; mx = hi;
+}
+
+#ifdef KERNELS_X86
+
+// ----------- AVX2 + FMA -----------
+
+__attribute__((target("avx2,fma")))
+double hsum256(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    __m128d sh = _mm_unpackhi_pd(lo, lo);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, sh));
+}
+
+__attribute__((target("avx2,fma")))
+double sumAvx2(const double* x, size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(x + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(x + i + 4));
+        a2 = _mm256_add_pd(a2, _mm256_loadu_pd(x + i + 8));
+        a3 = _mm256_add_pd(a3, _mm256_loadu_pd(x + i + 12));
+    }
+    double s = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    return s + sumScalar(x + i, n - i);
+}
+
+__attribute__((target("avx2,fma")))
+double sumSqDevAvx2(const double* x, size_t n, double m) {
+    __m256d vm = _mm256_set1_pd(m);
+    __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), vm);
+        __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), vm);
+        __m256d d2 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 8), vm);
+        __m256d d3 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 12), vm);
+        a0 = _mm256_fmadd_pd(d0, d0, a0);
+        a1 = _mm256_fmadd_pd(d1, d1, a1);
+        a2 = _mm256_fmadd_pd(d2, d2, a2);
+        a3 = _mm256_fmadd_pd(d3, d3, a3);
+    }
+    double s = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    return s + sumSqDevScalar(x + i, n - i, m);
+}
+
+__attribute__((target("avx2,fma")))
+Kernels::CrossDev crossDevAvx2(const double* x, const double* y, size_t n, double mx, double my) {
+    __m256d vmx = _mm256_set1_pd(mx), vmy = _mm256_set1_pd(my);
+    __m256d xx0 = _mm256_setzero_pd(), xx1 = xx0, yy0 = xx0, yy1 = xx0, xy0 = xx0, xy1 = xx0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d dx0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), vmx);
+        __m256d dy0 = _mm256_sub_pd(_mm256_loadu_pd(y + i), vmy);
+        __m256d dx1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), vmx);
+        __m256d dy1 = _mm256_sub_pd(_mm256_loadu_pd(y + i + 4), vmy);
+        xx0 = _mm256_fmadd_pd(dx0, dx0, xx0); xx1 = _mm256_fmadd_pd(dx1, dx1, xx1);
+        yy0 = _mm256_fmadd_pd(dy0, dy0, yy0); yy1 = _mm256_fmadd_pd(dy1, dy1, yy1);
+        xy0 = _mm256_fmadd_pd(dx0, dy0, xy0); xy1 = _mm256_fmadd_pd(dx1, dy1, xy1);
+    }
+    Kernels::CrossDev tail = crossDevScalar(x + i, y + i, n - i, mx, my);
+    Kernels::CrossDev r;
+    r.sxx = hsum256(_mm256_add_pd(xx0, xx1)) + tail.sxx;
+    r.syy = hsum256(_mm256_add_pd(yy0, yy1)) + tail.syy;
+    r.sxy = hsum256(_mm256_add_pd(xy0, xy1)) + tail.sxy;
+    return r;
+}
+
+__attribute__((target("avx2,fma")))
+void minMaxAvx2(const double* x, size_t n, double& mn, double& mx) {
+    if (n < 8) { minMaxScalar(x, n, mn, mx); return; }
+    __m256d lo0 = _mm256_loadu_pd(x), hi0 = lo0, lo1 = _mm256_loadu_pd(x + 4), hi1 = lo1;
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m256d v0 = _mm256_loadu_pd(x + i), v1 = _mm256_loadu_pd(x + i + 4);
+        lo0 = _mm256_min_pd(lo0, v0); hi0 = _mm256_max_pd(hi0, v0);
+        lo1 = _mm256_min_pd(lo1, v1); hi1 = _mm256_max_pd(hi1, v1);
+    }
+    alignas(32) double l[4], h[4];
+    _mm256_store_pd(l, _mm256_min_pd(lo0, lo1));
+    _mm256_store_pd(h, _mm256_max_pd(hi0, hi1));
+    double lo = l[0], hi = h[0];
+    for (int k = 1; k < 4; ++k) { if (l[k] < lo) lo = l[k]; if (h[k] > hi) hi = h[k]; }
+    for (; i < n; ++i) { if (x[i] < lo) lo = x[i]; if (x[i] > hi) hi = x[i]; }
+    mn = lo; mx = hi;
+}
+
+// ----------- AVX-512 -----------
+
+// Réductions horizontales explicites : les intrinsèques de réduction de GCC 12
+// passent par des registres "undefined" qui déclenchent -Wmaybe-uninitialized.
+// Même ordre d'addition qu'elles (moitiés 256 bits, puis 128, puis 64).
+__attribute__((target("avx512f")))
+double hsum512(__m512d v) {
+    alignas(64) double t[8];
+    _mm512_store_pd(t, v);
+    double s0 = t[0] + t[4], s1 = t[1] + t[5], s2 = t[2] + t[6], s3 = t[3] + t[7];
+    return (s0 + s2) + (s1 + s3);
+}
+
+__attribute__((target("avx512f")))
+void hminMax512(__m512d lo, __m512d hi, double& mn, double& mx) {
+    alignas(64) double l[8], h[8];
+    _mm512_store_pd(l, lo);
+    _mm512_store_pd(h, hi);
+    mn = l[0]; mx = h[0];
+    for (int k = 1; k < 8; ++k) { if (l[k] < mn) mn = l[k]; if (h[k] > mx) mx = h[k]; }
+}
+
+__attribute__((target("avx512f")))
+double sumAvx512(const double* x, size_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        a0 = _mm512_add_pd(a0, _mm512_loadu_pd(x + i));
+        a1 = _mm512_add_pd(a1, _mm512_loadu_pd(x + i + 8));
+        a2 = _mm512_add_pd(a2, _mm512_loadu_pd(x + i + 16));
+        a3 = _mm512_add_pd(a3, _mm512_loadu_pd(x + i + 24));
+    }
+    double s = hsum512(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+    return s + sumScalar(x + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+double sumSqDevAvx512(const double* x, size_t n, double m) {
+    __m512d vm = _mm512_set1_pd(m);
+    __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512d d0 = _mm512_sub_pd(_mm512_loadu_pd(x + i), vm);
+        __m512d d1 = _mm512_sub_pd(_mm512_loadu_pd(x + i + 8), vm);
+        __m512d d2 = _mm512_sub_pd(_mm512_loadu_pd(x + i + 16), vm);
+        __m512d d3 = _mm512_sub_pd(_mm512_loadu_pd(x + i + 24), vm);
+        a0 = _mm512_fmadd_pd(d0, d0, a0);
+        a1 = _mm512_fmadd_pd(d1, d1, a1);
+        a2 = _mm512_fmadd_pd(d2, d2, a2);
+        a3 = _mm512_fmadd_pd(d3, d3, a3);
+    }
+    double s = hsum512(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+    return s + sumSqDevScalar(x + i, n - i, m);
+}
+
+__attribute__((target("avx512f")))
+Kernels::CrossDev crossDevAvx512(const double* x, const double* y, size_t n, double mx, double my) {
+    __m512d vmx = _mm512_set1_pd(mx), vmy = _mm512_set1_pd(my);
+    __m512d xx0 = _mm512_setzero_pd(), xx1 = xx0, yy0 = xx0, yy1 = xx0, xy0 = xx0, xy1 = xx0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d dx0 = _mm512_sub_pd(_mm512_loadu_pd(x + i), vmx);
+        __m512d dy0 = _mm512_sub_pd(_mm512_loadu_pd(y + i), vmy);
+        __m512d dx1 = _mm512_sub_pd(_mm512_loadu_pd(x + i + 8), vmx);
+        __m512d dy1 = _mm512_sub_pd(_mm512_loadu_pd(y + i + 8), vmy);
+        xx0 = _mm512_fmadd_pd(dx0, dx0, xx0); xx1 = _mm512_fmadd_pd(dx1, dx1, xx1);
+        yy0 = _mm512_fmadd_pd(dy0, dy0, yy0); yy1 = _mm512_fmadd_pd(dy1, dy1, yy1);
+        xy0 = _mm512_fmadd_pd(dx0, dy0, xy0); xy1 = _mm512_fmadd_pd(dx1, dy1, xy1);
+    }
+    Kernels::CrossDev tail = crossDevScalar(x + i, y + i, n - i, mx, my);
+    Kernels::CrossDev r;
+    r.sxx = hsum512(_mm512_add_pd(xx0, xx1)) + tail.sxx;
+    r.syy = hsum512(_mm512_add_pd(yy0, yy1)) + tail.syy;
+    r.sxy = hsum512(_mm512_add_pd(xy0, xy1)) + tail.sxy;
+    return r;
+}
+
+__attribute__((target("avx512f")))
+void minMaxAvx512(const double* x, size_t n, double& mn, double& mx) {
+    if (n < 8) { minMaxScalar(x, n, mn, mx); return; }
+    __m512d lo = _mm512_loadu_pd(x), hi = lo;
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_loadu_pd(x + i);
+        // Formes masquées : source explicite, pas de registre "undefined"
+        lo = _mm512_mask_min_pd(lo, 0xFF, lo, v);
+        hi = _mm512_mask_max_pd(hi, 0xFF, hi, v);
+    }
+    double l, h;
+    hminMax512(lo, hi, l, h);
+    for (; i < n; ++i) { if (x[i] < l) l = x[i]; if (x[i] > h) h = x[i]; }
+    mn = l; mx = h;
+}
+
+#endif // KERNELS_X86
+
+// ----------- Sélection à l'exécution -----------
+
+Kernels::Isa bestIsa() {
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Kernels::Isa::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Kernels::Isa::Avx2;
+#endif
+    return Kernels::Isa::Scalar;
+}
+
+struct Dispatch {
+    Kernels::Isa isa;
+    double (*sum)(const double*, size_t);
+    double (*sumSqDev)(const double*, size_t, double);
+    Kernels::CrossDev (*crossDev)(const double*, const double*, size_t, double, double);
+    void (*minMax)(const double*, size_t, double&, double&);
+};
+
+Dispatch makeDispatch(Kernels::Isa isa) {
+#ifdef KERNELS_X86
+    if (isa == Kernels::Isa::Avx512) return { isa, sumAvx512, sumSqDevAvx512, crossDevAvx512, minMaxAvx512 };
+    if (isa == Kernels::Isa::Avx2)   return { isa, sumAvx2, sumSqDevAvx2, crossDevAvx2, minMaxAvx2 };
+#endif
+    return { Kernels::Isa::Scalar, sumScalar, sumSqDevScalar, crossDevScalar, minMaxScalar };
+}
+
+// Une table constante par jeu d'instructions : setIsa ne change que le pointeur
+// courant, atomique car lu par les threads du pool pendant un calcul.
+const Dispatch& tableFor(Kernels::Isa isa) {
+    static const Dispatch tables[3] = {
+        makeDispatch(Kernels::Isa::Scalar), makeDispatch(Kernels::Isa::Avx2), makeDispatch(Kernels::Isa::Avx512)
+    };
+    return tables[(int)isa];
+}
+
+std::atomic<const Dispatch*>& current() {
+    static std::atomic<const Dispatch*> d{&tableFor(bestIsa())};
+    return d;
+}
+
+const Dispatch& dispatch() {
+    return *current().load(std::memory_order_acquire);
+}
+
+} // namespace
+
+Kernels::Isa Kernels::isa() {
+    return dispatch().isa;
+}
+
+const char* Kernels::isaName() {
+    switch (isa()) {
+        case Isa::Avx512: return "avx512";
+        case Isa::Avx2:   return "avx2";
+        default:          return "scalaire";
+    }
+}
+
+void Kernels::setIsa(Isa wanted) {
+    Isa best = bestIsa();
+    if ((int)wanted > (int)best) wanted = best;
+    current().store(&tableFor(wanted), std::memory_order_release);
+}
+
+double Kernels::sum(const double* x, size_t n) {
+    return dispatch().sum(x, n);
+}
+
+double Kernels::sumSqDev(const double* x, size_t n, double m) {
+    return dispatch().sumSqDev(x, n, m);
+}
+
+Kernels::CrossDev Kernels::crossDev(const double* x, const double* y, size_t n, double mx, double my) {
+    return dispatch().crossDev(x, y, n, mx, my);
+}
+
+void Kernels::minMax(const double* x, size_t n, double& mn, double& mx) {
+    dispatch().minMax(x, n, mn, mx);
+}
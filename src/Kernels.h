@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+
+/*
+  Kernels : noyaux de réduction (sommes, écarts, produits croisés, min/max) utilisés
+  par StatDesc et StatInfer.
+
+  Trois implémentations choisies à l'exécution selon le processeur :
+    - AVX-512 (8 doubles par registre, 4 accumulateurs indépendants)
+    - AVX2 + FMA (4 doubles par registre, 4 accumulateurs indépendants)
+    - scalaire (4 accumulateurs indépendants, repli sur toute autre machine)
+
+  Précision : les accumulateurs multiples changent l'ordre des additions par rapport
+  à une boucle séquentielle, donc les derniers bits peuvent différer. La borne
+  d'erreur reste du même ordre, et en fait meilleure : environ (n/k + log2 k)·eps·Σ|x|
+  avec k voies parallèles, contre n·eps·Σ|x| pour la somme séquentielle d'origine.
+  Pour chaque jeu d'instructions, l'écart relatif avec une boucle séquentielle
+  (sommes, Σ(x-m)², produits croisés) est < 1e-13 et min/max sont exacts :
+  vérifié par tests/KernelsTest.cpp.
+  Les variances restent calculées en deux passes (moyenne puis Σ(x-m)²), comme avant.
+  Avec des NaN, le résultat de minMax n'est pas spécifié.
+*/
+class Kernels {
+public:
+    enum class Isa { Scalar, Avx2, Avx512 };
+
+    // Jeu d'instructions utilisé (détecté au premier appel)
+    static Isa isa();
+    static const char* isaName();
+    // Force un jeu d'instructions (ramené au meilleur disponible s'il n'est pas supporté).
+    // Appelable à tout moment : un noyau déjà lancé se termine avec l'ancienne version.
+    static void setIsa(Isa wanted);
+
+    // Σ x
+    static double sum(const double* x, size_t n);
+    // Σ (x - m)²
+    static double sumSqDev(const double* x, size_t n, double m);
+
+    // Σ (x-mx)², Σ (y-my)², Σ (x-mx)(y-my)
+    struct CrossDev {
+        double sxx = 0.0;
+        double syy = 0.0;
+        double sxy = 0.0;
+    };
+    static CrossDev crossDev(const double* x, const double* y, size_t n, double mx, double my);
+
+    // Minimum et maximum (inchangés si n == 0)
+    static void minMax(const double* x, size_t n, double& mn, double& mx);
+};
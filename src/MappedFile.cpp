@@ -0,0 +1,78 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : ptr(nullptr), len(0), fileHandle(nullptr), mappingHandle(nullptr) {}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    HANDLE f = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz)) { CloseHandle(f); return false; }
+    fileHandle = f;
+    if (sz.QuadPart == 0) return true; // fichier vide : rien à projeter
+
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m) { close(); return false; }
+    mappingHandle = m;
+
+    void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!p) { close(); return false; }
+    ptr = static_cast<const char*>(p);
+    len = (size_t)sz.QuadPart;
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) UnmapViewOfFile(ptr);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    ptr = nullptr; len = 0;
+    fileHandle = nullptr; mappingHandle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile() : ptr(nullptr), len(0) {}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+    if (st.st_size == 0) { ::close(fd); return true; } // fichier vide : rien à projeter
+
+    void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // la projection reste valide après fermeture du descripteur
+    if (p == MAP_FAILED) return false;
+
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+    ptr = static_cast<const char*>(p);
+    len = (size_t)st.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) munmap(const_cast<char*>(ptr), len);
+    ptr = nullptr; len = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/*
+  MappedFile : projection en mémoire (mmap / MapViewOfFile) d'un fichier en lecture seule.
+
+  Le contenu est accessible directement via data()/view() sans copie ni lecture
+  ligne par ligne. La projection est libérée à la destruction (RAII).
+  Un fichier vide s'ouvre correctement avec size() == 0.
+*/
+class MappedFile {
+private:
+    const char* ptr;
+    size_t len;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Non copiable (la projection appartient à un seul objet)
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Ouvre et projette le fichier. Renvoie false si le fichier ne peut pas être ouvert.
+    bool open(const std::string& filename);
+    void close();
+
+    const char* data() const { return ptr; }
+    size_t size() const { return len; }
+    std::string_view view() const { return std::string_view(ptr, len); }
+};
@@ -0,0 +1,230 @@
+#include "OnlineStats.h"
+#include <cmath>
+
+// --- MOMENTS ---
+// Mise à jour incrémentale de la moyenne et des moments centrés M2..M4 :
+// pas de seconde passe, stable même pour de grandes valeurs.
+void Moments::add(double x) {
+    double n1 = (double)n;
+    n++;
+    double nd = (double)n;
+    double delta = x - mu;
+    double deltaN = delta / nd;
+    double deltaN2 = deltaN * deltaN;
+    double term1 = delta * deltaN * n1;
+    mu += deltaN;
+    m4 += term1 * deltaN2 * (nd*nd - 3*nd + 3) + 6 * deltaN2 * m2 - 4 * deltaN * m3;
+    m3 += term1 * deltaN * (nd - 2) - 3 * deltaN * m2;
+    m2 += term1;
+    total += x;
+    if (n == 1) { mn = x; mx = x; }
+    else {
+        if (x < mn) mn = x;
+        if (x > mx) mx = x;
+    }
+}
+
+// Combinaison de deux ensembles de moments (Chan et al. pour M2, Pébay pour M3/M4)
+void Moments::merge(const Moments& o) {
+    if (o.n == 0) return;
+    if (n == 0) { *this = o; return; }
+
+    double na = (double)n, nb = (double)o.n, nt = na + nb;
+    double delta = o.mu - mu;
+    double delta2 = delta * delta;
+    double delta3 = delta2 * delta;
+    double delta4 = delta2 * delta2;
+
+    double newM2 = m2 + o.m2 + delta2 * na * nb / nt;
+    double newM3 = m3 + o.m3 + delta3 * na * nb * (na - nb) / (nt * nt)
+                 + 3.0 * delta * (na * o.m2 - nb * m2) / nt;
+    double newM4 = m4 + o.m4 + delta4 * na * nb * (na*na - na*nb + nb*nb) / (nt * nt * nt)
+                 + 6.0 * delta2 * (na*na * o.m2 + nb*nb * m2) / (nt * nt)
+                 + 4.0 * delta * (na * o.m3 - nb * m3) / nt;
+
+    mu += delta * nb / nt;
+    m2 = newM2;
+    m3 = newM3;
+    m4 = newM4;
+    n += o.n;
+    total += o.total;
+    if (o.mn < mn) mn = o.mn;
+    if (o.mx > mx) mx = o.mx;
+}
+
+double Moments::variance(bool sample) const {
+    if (n < 2) return 0.0;
+    return m2 / (n - (sample ? 1 : 0));
+}
+
+double Moments::stddev(bool sample) const {
+    return std::sqrt(variance(sample));
+}
+
+double Moments::skewness() const {
+    if (m2 <= 0) return 0.0;
+    return std::sqrt((double)n) * m3 / std::pow(m2, 1.5);
+}
+
+double Moments::kurtosis() const {
+    if (m2 <= 0) return 0.0;
+    return n * m4 / (m2 * m2) - 3.0;
+}
+
+// --- MOMENTS CROISES ---
+void CoMoments::add(double x, double y) {
+    n++;
+    double dx = x - mx;
+    double dy = y - my;
+    mx += dx / n;
+    my += dy / n;
+    // écart à l'ancienne moyenne * écart à la nouvelle : forme de Welford
+    sxx += dx * (x - mx);
+    syy += dy * (y - my);
+    sxy += dx * (y - my);
+}
+
+void CoMoments::merge(const CoMoments& o) {
+    if (o.n == 0) return;
+    if (n == 0) { *this = o; return; }
+
+    double na = (double)n, nb = (double)o.n, nt = na + nb;
+    double dx = o.mx - mx, dy = o.my - my;
+    double f = na * nb / nt;
+    sxx += o.sxx + dx * dx * f;
+    syy += o.syy + dy * dy * f;
+    sxy += o.sxy + dx * dy * f;
+    mx += dx * nb / nt;
+    my += dy * nb / nt;
+    n += o.n;
+}
+
+double CoMoments::pearson() const {
+    if (sxx == 0 || syy == 0) return 0.0;
+    return sxy / std::sqrt(sxx * syy);
+}
+
+double CoMoments::slope() const {
+    return (sxx == 0) ? 0.0 : sxy / sxx;
+}
+
+double CoMoments::intercept() const {
+    return my - slope() * mx;
+}
+
+double CoMoments::r2() const {
+    double r = pearson();
+    return r * r;
+}
+
+// --- MATRICE DE CO-MOMENTS ---
+CoMomentMatrix::CoMomentMatrix(size_t nbCols) : k(nbCols), n(0), mu(nbCols, 0.0), c(nbCols * nbCols, 0.0) {}
+
+void CoMomentMatrix::add(const double* row) {
+    n++;
+    // d[i] = écart à l'ancienne moyenne ; c[i][j] += d[i] * écart à la nouvelle moyenne
+    std::vector<double> d(k);
+    for (size_t i = 0; i < k; ++i) {
+        d[i] = row[i] - mu[i];
+        mu[i] += d[i] / n;
+    }
+    for (size_t i = 0; i < k; ++i)
+        for (size_t j = 0; j < k; ++j)
+            c[i * k + j] += d[i] * (row[j] - mu[j]);
+}
+
+// Welford à l'envers : ancienne moyenne m' = (n*m - x)/(n-1), puis
+// c[i][j] -= (x[i] - m'[i]) * (x[j] - m[j]) (même terme que celui ajouté par add).
+void CoMomentMatrix::remove(const double* row) {
+    if (n <= 1) { *this = CoMomentMatrix(k); return; }
+    n--;
+    std::vector<double> d(k);
+    for (size_t i = 0; i < k; ++i) {
+        d[i] = row[i] - mu[i];           // écart à la moyenne avec la ligne
+        mu[i] -= d[i] / n;               // moyenne sans la ligne
+    }
+    for (size_t i = 0; i < k; ++i)
+        for (size_t j = 0; j < k; ++j)
+            c[i * k + j] -= (row[i] - mu[i]) * d[j];
+}
+
+// Deux passes sur le bloc (moyennes puis co-déviations), les valeurs restent en cache.
+void CoMomentMatrix::addBlock(const double* const* cols, size_t begin, size_t end) {
+    std::vector<double> bm(k), bc(k * k);
+    while (begin < end) {
+        size_t stop = (end - begin > BLOCK) ? begin + BLOCK : end;
+        size_t nb = stop - begin;
+
+        for (size_t i = 0; i < k; ++i) {
+            double s = 0.0;
+            for (size_t r = begin; r < stop; ++r) s += cols[i][r];
+            bm[i] = s / nb;
+        }
+
+        for (size_t i = 0; i < k; ++i) {
+            const double* xi = cols[i];
+            for (size_t j = i; j < k; ++j) {
+                const double* xj = cols[j];
+                double s = 0.0;
+                for (size_t r = begin; r < stop; ++r) s += (xi[r] - bm[i]) * (xj[r] - bm[j]);
+                bc[i * k + j] = s;
+                bc[j * k + i] = s;
+            }
+        }
+        mergeBlock(nb, bm.data(), bc.data());
+        begin = stop;
+    }
+}
+
+// Formule de Chan généralisée : C = Ca + Cb + (mb-ma)(mb-ma)' * na*nb/n
+void CoMomentMatrix::mergeBlock(size_t nb, const double* blockMean, const double* blockC) {
+    if (nb == 0) return;
+    double na = (double)n, nbd = (double)nb, nt = na + nbd;
+    double f = na * nbd / nt;
+    for (size_t i = 0; i < k; ++i) {
+        double di = blockMean[i] - mu[i];
+        for (size_t j = 0; j < k; ++j)
+            c[i * k + j] += blockC[i * k + j] + di * (blockMean[j] - mu[j]) * f;
+    }
+    for (size_t i = 0; i < k; ++i) mu[i] += (blockMean[i] - mu[i]) * nbd / nt;
+    n += nb;
+}
+
+void CoMomentMatrix::merge(const CoMomentMatrix& o) {
+    if (o.n == 0) return;
+    if (n == 0) { *this = o; return; }
+    mergeBlock(o.n, o.mu.data(), o.c.data());
+}
+
+double CoMomentMatrix::covariance(size_t i, size_t j, bool sample) const {
+    if (n < 2) return 0.0;
+    return coDev(i, j) / (n - (sample ? 1 : 0));
+}
+
+double CoMomentMatrix::pearson(size_t i, size_t j) const {
+    double sii = coDev(i, i), sjj = coDev(j, j);
+    if (sii == 0 || sjj == 0) return 0.0;
+    return coDev(i, j) / std::sqrt(sii * sjj);
+}
+
+// --- TEST T (WELCH) ---
+void TTestState::merge(const TTestState& o) {
+    first.merge(o.first);
+    second.merge(o.second);
+}
+
+double TTestState::welchT() const {
+    size_t n1 = first.count(), n2 = second.count();
+    if (n1 < 2 || n2 < 2) return 0.0;
+    double v = first.variance() / n1 + second.variance() / n2;
+    if (v == 0) return 0.0;    // deux échantillons constants : même garde que StatInfer::welchTest
+    return (first.mean() - second.mean()) / std::sqrt(v);
+}
+
+double TTestState::welchDf() const {
+    size_t n1 = first.count(), n2 = second.count();
+    if (n1 < 2 || n2 < 2) return 0.0;
+    double v1 = first.variance() / n1, v2 = second.variance() / n2;
+    double den = v1 * v1 / (n1 - 1) + v2 * v2 / (n2 - 1);
+    return (den == 0) ? 0.0 : (v1 + v2) * (v1 + v2) / den;
+}
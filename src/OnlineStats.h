@@ -0,0 +1,110 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/*
+  OnlineStats : accumulateurs en un passage, à mémoire constante.
+
+  Chaque accumulateur reçoit les valeurs une par une (add) et peut être fusionné
+  avec un autre (merge) : on peut donc découper une colonne ou un flux en morceaux,
+  accumuler chaque morceau séparément puis combiner les résultats. Le résultat d'une
+  fusion est celui qu'on aurait obtenu en accumulant les deux morceaux à la suite
+  (aux arrondis près).
+*/
+
+// Moments centrés jusqu'à l'ordre 4 (Welford / Terriberry), plus somme, min et max.
+class Moments {
+private:
+    size_t n = 0;
+    double mu = 0.0;
+    double m2 = 0.0, m3 = 0.0, m4 = 0.0; // sommes des (x-mean)^k
+    double total = 0.0;
+    double mn = 0.0, mx = 0.0;
+
+public:
+    void add(double x);
+    void merge(const Moments& other); // formules de Chan / Pébay
+
+    size_t count() const { return n; }
+    double sum() const { return total; }
+    double mean() const { return mu; }
+    double sumSqDev() const { return m2; }
+    double min() const { return mn; }
+    double max() const { return mx; }
+    double amplitude() const { return mx - mn; }
+
+    double variance(bool sample=true) const;
+    double stddev(bool sample=true) const;
+    double skewness() const;  // g1 = sqrt(n)*M3 / M2^1.5
+    double kurtosis() const;  // kurtosis en excès g2 = n*M4 / M2^2 - 3
+};
+
+// Moments croisés d'un couple (x, y) : corrélation et régression simple y = a*x + b.
+class CoMoments {
+private:
+    size_t n = 0;
+    double mx = 0.0, my = 0.0;
+    double sxx = 0.0, syy = 0.0, sxy = 0.0;
+
+public:
+    void add(double x, double y);
+    void merge(const CoMoments& other);
+
+    size_t count() const { return n; }
+    double meanX() const { return mx; }
+    double meanY() const { return my; }
+
+    double pearson() const;   // 0 si une des variances est nulle
+    double slope() const;     // a
+    double intercept() const; // b
+    double r2() const;
+};
+
+// Test t de Welch entre deux échantillons alimentés séparément.
+class TTestState {
+public:
+    Moments first, second;
+
+    void addFirst(double x) { first.add(x); }
+    void addSecond(double y) { second.add(y); }
+    void merge(const TTestState& other);
+
+    // (m1-m2) / sqrt(s1²/n1 + s2²/n2), 0 si un échantillon a moins de 2 valeurs
+    // ou si les deux sont constants
+    double welchT() const;
+    // Degrés de liberté de Welch-Satterthwaite (0 si welchT n'est pas défini)
+    double welchDf() const;
+};
+
+// Matrice des co-moments de k colonnes : moyennes et sommes des (xi-mi)(xj-mj).
+// Donne toutes les covariances / corrélations de Pearson en un seul parcours.
+// addBlock traite BLOCK lignes à la fois : moyennes et co-moments du bloc calculés
+// pendant qu'il est en cache, puis fusion du bloc dans l'accumulateur.
+// remove retire une ligne en O(k²) (mise à jour d'une valeur = remove + add) ;
+// l'erreur d'arrondi s'accumule avec les retraits, un recalcul complet la remet à zéro.
+class CoMomentMatrix {
+private:
+    size_t k = 0;
+    size_t n = 0;
+    std::vector<double> mu; // k moyennes
+    std::vector<double> c;  // k*k, symétrique
+
+    void mergeBlock(size_t nb, const double* blockMean, const double* blockC);
+
+public:
+    static constexpr size_t BLOCK = 256;
+
+    explicit CoMomentMatrix(size_t nbCols = 0);
+
+    void add(const double* row);                                   // row[0..k)
+    void remove(const double* row);                                // inverse de add (row déjà ajoutée)
+    void addBlock(const double* const* cols, size_t begin, size_t end); // cols[j][begin..end)
+    void merge(const CoMomentMatrix& other);
+
+    size_t dim() const { return k; }
+    size_t count() const { return n; }
+    double mean(size_t i) const { return mu[i]; }
+    double coDev(size_t i, size_t j) const { return c[i * k + j]; }
+    double covariance(size_t i, size_t j, bool sample=true) const;
+    double pearson(size_t i, size_t j) const; // 0 si une des variances est nulle
+};
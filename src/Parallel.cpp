@@ -0,0 +1,69 @@
+#include "Parallel.h"
+
+// --- SOMMES ---
+// Somme de chaque morceau par le noyau vectorisé, puis somme des partiels.
+double Parallel::sum(const double* x, size_t n) {
+    return reduce(n, 0.0,
+        [x](size_t b, size_t e) { return Kernels::sum(x + b, e - b); },
+        [](double& acc, double p) { acc += p; });
+}
+
+double Parallel::sumSqDev(const double* x, size_t n, double mean) {
+    return reduce(n, 0.0,
+        [x, mean](size_t b, size_t e) { return Kernels::sumSqDev(x + b, e - b, mean); },
+        [](double& acc, double p) { acc += p; });
+}
+
+Kernels::CrossDev Parallel::crossDev(const double* x, const double* y, size_t n, double mx, double my) {
+    return reduce(n, Kernels::CrossDev{0.0, 0.0, 0.0},
+        [=](size_t b, size_t e) { return Kernels::crossDev(x + b, y + b, e - b, mx, my); },
+        [](Kernels::CrossDev& acc, const Kernels::CrossDev& p) {
+            acc.sxx += p.sxx;
+            acc.syy += p.syy;
+            acc.sxy += p.sxy;
+        });
+}
+
+// --- MIN / MAX ---
+// n == 0 -> mn = mx = 0 (Kernels::minMax, lui, demande n > 0).
+void Parallel::minMax(const double* x, size_t n, double& mn, double& mx) {
+    if (n == 0) {
+        mn = mx = 0.0;
+        return;
+    }
+    struct Range { double lo, hi; };
+    Range r = reduce(n, Range{x[0], x[0]},
+        [x](size_t b, size_t e) {
+            Range p;
+            Kernels::minMax(x + b, e - b, p.lo, p.hi);
+            return p;
+        },
+        [](Range& acc, const Range& p) {
+            if (p.lo < acc.lo) acc.lo = p.lo;
+            if (p.hi > acc.hi) acc.hi = p.hi;
+        });
+    mn = r.lo;
+    mx = r.hi;
+}
+
+// --- MOMENTS ---
+Moments Parallel::moments(const double* x, size_t n) {
+    return reduce(n, Moments(),
+        [x](size_t b, size_t e) {
+            Moments m;
+            for (size_t i = b; i < e; ++i) m.add(x[i]);
+            return m;
+        },
+        [](Moments& acc, const Moments& p) { acc.merge(p); });
+}
+
+// --- MATRICE DE CO-MOMENTS ---
+CoMomentMatrix Parallel::coMoments(const std::vector<const double*>& cols, size_t n) {
+    return reduce(n, CoMomentMatrix(cols.size()),
+        [&cols](size_t b, size_t e) {
+            CoMomentMatrix m(cols.size());
+            m.addBlock(cols.data(), b, e);
+            return m;
+        },
+        [](CoMomentMatrix& acc, const CoMomentMatrix& p) { acc.merge(p); });
+}
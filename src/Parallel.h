@@ -0,0 +1,62 @@
+#pragma once
+#include "ThreadPool.h"
+#include "Kernels.h"
+#include "OnlineStats.h"
+#include <vector>
+#include <cstddef>
+
+/*
+  Parallel : map-reduce sur les colonnes via ThreadPool::global().
+
+  Les lignes sont découpées en morceaux de CHUNK lignes (découpage fixe, qui ne dépend
+  pas du nombre de threads). Chaque morceau produit un état partiel (somme, compteur,
+  Moments...) dans sa propre case, puis les états sont combinés dans l'ordre des
+  morceaux sur le thread appelant. Le résultat est donc identique au bit près quel
+  que soit le nombre de threads, et pour n <= CHUNK il est celui du calcul séquentiel.
+*/
+class Parallel {
+public:
+    static constexpr size_t CHUNK = 1 << 16;
+
+    static size_t nbChunks(size_t n) { return (n + CHUNK - 1) / CHUNK; }
+
+    // chunkFn(begin, end) -> T pour chaque morceau ; combine(acc, partiel) dans l'ordre.
+    template <class T, class ChunkFn, class Combine>
+    static T reduce(size_t n, T init, ChunkFn chunkFn, Combine combine) {
+        size_t k = nbChunks(n);
+        std::vector<T> parts(k, init);
+        ThreadPool::global().parallelFor(k, [&](size_t c) {
+            size_t begin = c * CHUNK;
+            size_t end = (begin + CHUNK < n) ? begin + CHUNK : n;
+            parts[c] = chunkFn(begin, end);
+        });
+        T acc = init;
+        for (const T& p : parts) combine(acc, p);
+        return acc;
+    }
+
+    // Nombre d'indices i dans [0, n) tels que pred(i)
+    template <class Pred>
+    static size_t count(size_t n, Pred pred) {
+        return reduce(n, size_t(0),
+            [&](size_t begin, size_t end) {
+                size_t c = 0;
+                for (size_t i = begin; i < end; ++i) if (pred(i)) c++;
+                return c;
+            },
+            [](size_t& acc, size_t c) { acc += c; });
+    }
+
+    // Versions parallèles des noyaux de Kernels (mêmes conventions)
+    static double sum(const double* x, size_t n);
+    static double sumSqDev(const double* x, size_t n, double mean);
+    static Kernels::CrossDev crossDev(const double* x, const double* y, size_t n, double mx, double my);
+    static void minMax(const double* x, size_t n, double& mn, double& mx); // 0, 0 si n == 0
+
+    // Moments accumulés par morceau puis fusionnés (Chan / Pébay)
+    static Moments moments(const double* x, size_t n);
+
+    // Matrice des co-moments de cols.size() colonnes de n lignes (blocs de
+    // CoMomentMatrix::BLOCK lignes dans chaque morceau)
+    static CoMomentMatrix coMoments(const std::vector<const double*>& cols, size_t n);
+};
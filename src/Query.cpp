@@ -0,0 +1,369 @@
+#include "Query.h"
+#include "SpotifyDataset.h"
+#include "Parallel.h"
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+using Token = Expression::Token;
+
+// ----------- Compilation -----------
+
+static bool isName(const Token& t, const char* name) {
+    return t.kind == Token::Name && t.text == name;
+}
+
+int Query::addExpr(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    Expression e;
+    if (!e.compile(t, pos, error)) return -1;
+    exprs.push_back(e);
+    return (int)exprs.size() - 1;
+}
+
+bool Query::compile(const std::string& text, std::string& error) {
+    exprs.clear();
+    aggregates.clear();
+    predicate.clear();
+    groupExpr = -1;
+    nbBuckets = 0;
+
+    std::vector<Token> t;
+    if (!Expression::tokenize(text, t, error)) return false;
+    size_t pos = 0;
+    if (!isName(t[pos], "select")) { error = "la requete commence par select"; return false; }
+    pos++;
+
+    // Liste des agrégats
+    static const struct { const char* name; AggKind kind; } AGGS[] = {
+        {"count", AggKind::Count}, {"sum", AggKind::Sum}, {"mean", AggKind::Mean},
+        {"min", AggKind::Min}, {"max", AggKind::Max},
+        {"variance", AggKind::Variance}, {"stddev", AggKind::Stddev}
+    };
+    do {
+        if (!aggregates.empty()) pos++; // virgule
+        Aggregate agg{AggKind::Count, -1, ""};
+        bool known = false;
+        for (const auto& a : AGGS)
+            if (isName(t[pos], a.name)) { agg.kind = a.kind; known = true; }
+        if (!known || t[pos+1].kind != Token::LParen) {
+            error = "agregat attendu (count(), sum, mean, min, max, variance, stddev) avant : " + t[pos].text;
+            return false;
+        }
+        std::string name = t[pos].text;
+        pos += 2;
+        if (agg.kind != AggKind::Count) {
+            agg.expr = addExpr(t, pos, error);
+            if (agg.expr < 0) return false;
+        }
+        if (t[pos].kind != Token::RParen) { error = "')' attendue apres " + name; return false; }
+        pos++;
+        agg.label = name + "(" + (agg.expr >= 0 ? exprs[agg.expr].text() : "") + ")";
+        aggregates.push_back(agg);
+    } while (t[pos].kind == Token::Comma);
+
+    if (isName(t[pos], "where")) {
+        pos++;
+        if (!parseOr(t, pos, error)) return false;
+        size_t depth = 0;
+        predDepth = 0;
+        for (const PredInstr& in : predicate) {
+            if (in.op == PredOp::Compare) depth++;
+            else if (in.op == PredOp::And || in.op == PredOp::Or) depth--;
+            if (depth > predDepth) predDepth = depth;
+        }
+    }
+
+    if (isName(t[pos], "group")) {
+        if (!isName(t[pos+1], "by") || !isName(t[pos+2], "bucket") || t[pos+3].kind != Token::LParen) {
+            error = "syntaxe : group by bucket(expr, k)";
+            return false;
+        }
+        pos += 4;
+        groupExpr = addExpr(t, pos, error);
+        if (groupExpr < 0) return false;
+        if (t[pos].kind != Token::Comma || t[pos+1].kind != Token::Number || t[pos+2].kind != Token::RParen) {
+            error = "syntaxe : group by bucket(expr, k)";
+            return false;
+        }
+        double k = t[pos+1].value;
+        if (k < 1 || k > 1000 || k != std::floor(k)) { error = "k doit etre un entier entre 1 et 1000"; return false; }
+        nbBuckets = (size_t)k;
+        pos += 3;
+    }
+
+    if (t[pos].kind != Token::End) { error = "inattendu : " + t[pos].text; return false; }
+    return true;
+}
+
+// or < and < not : precedence habituelle
+bool Query::parseOr(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    if (!parseAnd(t, pos, error)) return false;
+    while (isName(t[pos], "or")) {
+        pos++;
+        if (!parseAnd(t, pos, error)) return false;
+        predicate.push_back({PredOp::Or});
+    }
+    return true;
+}
+
+bool Query::parseAnd(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    if (!parseNot(t, pos, error)) return false;
+    while (isName(t[pos], "and")) {
+        pos++;
+        if (!parseNot(t, pos, error)) return false;
+        predicate.push_back({PredOp::And});
+    }
+    return true;
+}
+
+// Une '(' ouvre soit une expression ("(solo+1)/streams > 2"), soit un prédicat
+// ("(a > 1 or b < 2)") : on essaie la comparaison, puis on revient en arrière.
+bool Query::parseNot(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    if (isName(t[pos], "not")) {
+        pos++;
+        if (!parseNot(t, pos, error)) return false;
+        predicate.push_back({PredOp::Not});
+        return true;
+    }
+    if (t[pos].kind == Token::LParen) {
+        size_t savedPos = pos, savedPred = predicate.size(), savedExprs = exprs.size();
+        if (parseComparison(t, pos, error)) return true;
+        pos = savedPos;
+        predicate.resize(savedPred);
+        exprs.resize(savedExprs);
+        pos++;
+        if (!parseOr(t, pos, error)) return false;
+        if (t[pos].kind != Token::RParen) { error = "')' attendue"; return false; }
+        pos++;
+        return true;
+    }
+    return parseComparison(t, pos, error);
+}
+
+bool Query::parseComparison(const std::vector<Token>& t, size_t& pos, std::string& error) {
+    PredInstr in{PredOp::Compare};
+    in.lhs = addExpr(t, pos, error);
+    if (in.lhs < 0) return false;
+    static const struct { const char* text; CmpOp op; } CMPS[] = {
+        {"<", CmpOp::Lt}, {"<=", CmpOp::Le}, {">", CmpOp::Gt},
+        {">=", CmpOp::Ge}, {"==", CmpOp::Eq}, {"!=", CmpOp::Ne}
+    };
+    bool known = false;
+    if (t[pos].kind == Token::Op)
+        for (const auto& c : CMPS)
+            if (t[pos].text == c.text) { in.cmp = c.op; known = true; }
+    if (!known) { error = "comparaison attendue (< <= > >= == !=) apres " + exprs[in.lhs].text(); return false; }
+    pos++;
+    in.rhs = addExpr(t, pos, error);
+    if (in.rhs < 0) return false;
+    predicate.push_back(in);
+    return true;
+}
+
+// ----------- Exécution -----------
+
+namespace {
+
+// bits[w] bit j = f(a[64w+j], b[64w+j]) ; une boucle par comparaison, sans branche par ligne
+template <class F>
+void compareLoop(const double* a, const double* b, size_t count, uint64_t* bits, size_t words, F f) {
+    for (size_t w = 0; w < words; ++w) {
+        size_t base = w * 64;
+        size_t lim = (count > base) ? std::min<size_t>(64, count - base) : 0;
+        uint64_t word = 0;
+        for (size_t j = 0; j < lim; ++j) word |= (uint64_t)f(a[base + j], b[base + j]) << j;
+        bits[w] = word;
+    }
+}
+
+// Masque des lignes présentes dans un lot de 'count' lignes
+uint64_t validWord(size_t count, size_t w) {
+    size_t base = w * 64;
+    if (count >= base + 64) return ~uint64_t(0);
+    if (count <= base) return 0;
+    return (uint64_t(1) << (count - base)) - 1;
+}
+
+} // namespace
+
+void Query::select(const SpotifyDataset& data, size_t begin, size_t count,
+                   std::vector<std::vector<double>>& work, std::vector<uint64_t>& stack, uint64_t* bits) const {
+    if (predicate.empty()) {
+        for (size_t w = 0; w < WORDS; ++w) bits[w] = validWord(count, w);
+        return;
+    }
+    stack.resize(predDepth * WORDS);
+    size_t d = 0;
+    for (const PredInstr& in : predicate) {
+        switch (in.op) {
+            case PredOp::Compare: {
+                const double* a = exprs[in.lhs].evaluate(data, begin, count, work[in.lhs]);
+                const double* b = exprs[in.rhs].evaluate(data, begin, count, work[in.rhs]);
+                uint64_t* out = stack.data() + d * WORDS;
+                switch (in.cmp) {
+                    case CmpOp::Lt: compareLoop(a, b, count, out, WORDS, [](double x, double y) { return x < y; }); break;
+                    case CmpOp::Le: compareLoop(a, b, count, out, WORDS, [](double x, double y) { return x <= y; }); break;
+                    case CmpOp::Gt: compareLoop(a, b, count, out, WORDS, [](double x, double y) { return x > y; }); break;
+                    case CmpOp::Ge: compareLoop(a, b, count, out, WORDS, [](double x, double y) { return x >= y; }); break;
+                    case CmpOp::Eq: compareLoop(a, b, count, out, WORDS, [](double x, double y) { return x == y; }); break;
+                    case CmpOp::Ne: compareLoop(a, b, count, out, WORDS, [](double x, double y) { return x != y; }); break;
+                }
+                d++;
+                break;
+            }
+            case PredOp::Not: {
+                uint64_t* x = stack.data() + (d-1) * WORDS;
+                for (size_t w = 0; w < WORDS; ++w) x[w] = ~x[w] & validWord(count, w);
+                break;
+            }
+            case PredOp::And:
+            case PredOp::Or: {
+                uint64_t* x = stack.data() + (d-2) * WORDS;
+                const uint64_t* y = stack.data() + (d-1) * WORDS;
+                if (in.op == PredOp::And) for (size_t w = 0; w < WORDS; ++w) x[w] &= y[w];
+                else                      for (size_t w = 0; w < WORDS; ++w) x[w] |= y[w];
+                d--;
+                break;
+            }
+        }
+    }
+    std::copy(stack.begin(), stack.begin() + WORDS, bits);
+}
+
+// Passe 1 : bitmap de sélection complet (mots disjoints par morceau) + bornes de la
+// clé de groupe. Passe 2 : agrégats par groupe, en ne visitant que les bits à 1.
+Query::Result Query::run(const SpotifyDataset& data) const {
+    size_t n = data.size();
+    Result res;
+    res.total = n;
+    for (const Aggregate& a : aggregates) res.columns.push_back(a.label);
+
+    std::vector<uint64_t> bitmap((n + 63) / 64, 0);
+    struct Pass1 {
+        size_t selected = 0;
+        double mn = std::numeric_limits<double>::infinity();
+        double mx = -std::numeric_limits<double>::infinity();
+    };
+    Pass1 p1 = Parallel::reduce(n, Pass1(),
+        [&](size_t begin, size_t end) {
+            Pass1 part;
+            std::vector<std::vector<double>> work(exprs.size());
+            std::vector<uint64_t> stack;
+            for (size_t b = begin; b < end; b += Expression::BATCH) {
+                size_t count = std::min(Expression::BATCH, end - b);
+                uint64_t* bits = bitmap.data() + b / 64;
+                uint64_t local[WORDS];
+                select(data, b, count, work, stack, local);
+                size_t words = (count + 63) / 64;
+                std::copy(local, local + words, bits);
+                if (groupExpr < 0) {
+                    for (size_t w = 0; w < words; ++w) part.selected += (size_t)__builtin_popcountll(local[w]);
+                    continue;
+                }
+                const double* g = exprs[groupExpr].evaluate(data, b, count, work[groupExpr]);
+                for (size_t w = 0; w < words; ++w) {
+                    part.selected += (size_t)__builtin_popcountll(local[w]);
+                    for (uint64_t word = local[w]; word; word &= word - 1) {
+                        double v = g[w * 64 + (size_t)__builtin_ctzll(word)];
+                        if (!std::isfinite(v)) continue;
+                        if (v < part.mn) part.mn = v;
+                        if (v > part.mx) part.mx = v;
+                    }
+                }
+            }
+            return part;
+        },
+        [](Pass1& acc, const Pass1& p) {
+            acc.selected += p.selected;
+            if (p.mn < acc.mn) acc.mn = p.mn;
+            if (p.mx > acc.mx) acc.mx = p.mx;
+        });
+    res.selected = p1.selected;
+
+    size_t nbGroups = (groupExpr < 0) ? 1 : nbBuckets;
+    bool hasRange = (groupExpr < 0) || p1.mn <= p1.mx;
+    if (!hasRange) nbGroups = 0; // aucune clé finie : aucun groupe
+    double width = hasRange && groupExpr >= 0 ? (p1.mx - p1.mn) / (double)nbBuckets : 0.0;
+    size_t nbAggs = aggregates.size();
+
+    struct Pass2 {
+        std::vector<size_t> rows;     // par groupe
+        std::vector<Moments> moments; // groupe * nbAggs + agrégat
+    };
+    Pass2 init;
+    init.rows.assign(nbGroups, 0);
+    init.moments.assign(nbGroups * nbAggs, Moments());
+    Pass2 p2 = Parallel::reduce(n, init,
+        [&](size_t begin, size_t end) {
+            Pass2 part = init;
+            if (nbGroups == 0) return part;
+            std::vector<std::vector<double>> work(exprs.size());
+            std::vector<const double*> vals(nbAggs, nullptr);
+            for (size_t b = begin; b < end; b += Expression::BATCH) {
+                size_t count = std::min(Expression::BATCH, end - b);
+                const uint64_t* bits = bitmap.data() + b / 64;
+                size_t words = (count + 63) / 64;
+                bool any = false;
+                for (size_t w = 0; w < words; ++w) any |= (bits[w] != 0);
+                if (!any) continue; // lot entièrement filtré : aucune évaluation
+                for (size_t a = 0; a < nbAggs; ++a)
+                    if (aggregates[a].expr >= 0)
+                        vals[a] = exprs[aggregates[a].expr].evaluate(data, b, count, work[aggregates[a].expr]);
+                const double* g = (groupExpr >= 0) ? exprs[groupExpr].evaluate(data, b, count, work[groupExpr]) : nullptr;
+                for (size_t w = 0; w < words; ++w) {
+                    for (uint64_t word = bits[w]; word; word &= word - 1) {
+                        size_t j = w * 64 + (size_t)__builtin_ctzll(word);
+                        size_t grp = 0;
+                        if (g) {
+                            if (!std::isfinite(g[j])) continue;
+                            grp = (width > 0) ? (size_t)((g[j] - p1.mn) / width) : 0;
+                            if (grp >= nbGroups) grp = nbGroups - 1; // le max tombe dans la dernière classe
+                        }
+                        part.rows[grp]++;
+                        for (size_t a = 0; a < nbAggs; ++a) {
+                            if (!vals[a] || aggregates[a].expr < 0) continue;
+                            double v = vals[a][j];
+                            if (std::isfinite(v)) part.moments[grp * nbAggs + a].add(v);
+                        }
+                    }
+                }
+            }
+            return part;
+        },
+        [&](Pass2& acc, const Pass2& p) {
+            for (size_t g = 0; g < nbGroups; ++g) acc.rows[g] += p.rows[g];
+            for (size_t i = 0; i < acc.moments.size(); ++i) acc.moments[i].merge(p.moments[i]);
+        });
+
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    for (size_t g = 0; g < nbGroups; ++g) {
+        Group grp;
+        if (groupExpr < 0) {
+            grp.label = "tous";
+        } else {
+            std::ostringstream oss;
+            double lo = p1.mn + width * (double)g;
+            double hi = (g + 1 == nbGroups) ? p1.mx : p1.mn + width * (double)(g + 1);
+            oss << "[" << lo << " ; " << hi << ((g + 1 == nbGroups) ? "]" : ")");
+            grp.label = oss.str();
+        }
+        grp.rows = p2.rows[g];
+        for (size_t a = 0; a < nbAggs; ++a) {
+            const Moments& m = p2.moments[g * nbAggs + a];
+            bool empty = (m.count() == 0);
+            double v = NaN;
+            switch (aggregates[a].kind) {
+                case AggKind::Count:    v = (double)grp.rows; break;
+                case AggKind::Sum:      v = m.sum(); break;
+                case AggKind::Mean:     v = empty ? NaN : m.mean(); break;
+                case AggKind::Min:      v = empty ? NaN : m.min(); break;
+                case AggKind::Max:      v = empty ? NaN : m.max(); break;
+                case AggKind::Variance: v = (m.count() < 2) ? NaN : m.variance(); break;
+                case AggKind::Stddev:   v = (m.count() < 2) ? NaN : m.stddev(); break;
+            }
+            grp.values.push_back(v);
+        }
+        res.groups.push_back(grp);
+    }
+    return res;
+}
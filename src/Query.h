@@ -0,0 +1,86 @@
+#pragma once
+#include "Expression.h"
+#include "OnlineStats.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class SpotifyDataset;
+
+/*
+  Query : sélection + agrégation sur les colonnes.
+
+    select agg(expr) [, agg(expr) ...] [where predicat] [group by bucket(expr, k)]
+
+  agg : count() | sum | mean | min | max | variance | stddev
+  predicat : comparaisons expr op expr (op : < <= > >= == !=) combinées par
+             and / or / not et parenthèses.
+  bucket(expr, k) : k classes de même largeur entre le min et le max de expr
+             sur les lignes sélectionnées.
+
+  Exécution vectorisée : le prédicat est compilé une fois en programme postfixé
+  sur des bitmaps (1 bit par ligne, mots de 64 bits). Pour chaque lot de
+  Expression::BATCH lignes, chaque comparaison évalue ses deux expressions sur le
+  lot et produit les bits du lot, and/or/not combinent ensuite des mots entiers.
+  Les agrégats ne parcourent que les bits à 1. Morceaux de Parallel::CHUNK lignes
+  traités en parallèle et fusionnés dans l'ordre : résultat indépendant du nombre
+  de threads.
+
+  Valeurs non finies (NaN, ±inf : division par zéro) : comparaisons IEEE (avec NaN,
+  toutes fausses sauf !=) ; dans un agrégat, la ligne est ignorée pour cette valeur
+  (count() compte toutes les lignes du groupe). Une ligne dont la clé de groupe
+  n'est pas finie est sélectionnée (Result::selected) mais n'appartient à aucun groupe.
+*/
+class Query {
+public:
+    enum class AggKind { Count, Sum, Mean, Min, Max, Variance, Stddev };
+
+    struct Group {
+        std::string label;       // "tous" ou "[a ; b)"
+        size_t rows = 0;         // lignes sélectionnées du groupe
+        std::vector<double> values; // une valeur par agrégat
+    };
+    struct Result {
+        std::vector<std::string> columns; // libellés des agrégats
+        std::vector<Group> groups;
+        size_t selected = 0;
+        size_t total = 0;
+    };
+
+    // false + message si la requête est invalide
+    bool compile(const std::string& text, std::string& error);
+    Result run(const SpotifyDataset& data) const;
+
+private:
+    struct Aggregate {
+        AggKind kind;
+        int expr = -1;     // indice dans exprs (-1 pour count())
+        std::string label;
+    };
+    enum class PredOp { Compare, And, Or, Not };
+    enum class CmpOp { Lt, Le, Gt, Ge, Eq, Ne };
+    struct PredInstr {
+        PredOp op;
+        CmpOp cmp = CmpOp::Eq;
+        int lhs = -1, rhs = -1; // indices dans exprs (Compare)
+    };
+
+    std::vector<Expression> exprs;     // toutes les expressions de la requête
+    std::vector<Aggregate> aggregates;
+    std::vector<PredInstr> predicate;  // postfixé ; vide = toutes les lignes
+    size_t predDepth = 0;
+    int groupExpr = -1;                // expression de bucket(), -1 sans group by
+    size_t nbBuckets = 0;
+
+    static constexpr size_t WORDS = Expression::BATCH / 64; // mots de bitmap par lot
+
+    int addExpr(const std::vector<Expression::Token>& t, size_t& pos, std::string& error);
+    bool parseOr(const std::vector<Expression::Token>& t, size_t& pos, std::string& error);
+    bool parseAnd(const std::vector<Expression::Token>& t, size_t& pos, std::string& error);
+    bool parseNot(const std::vector<Expression::Token>& t, size_t& pos, std::string& error);
+    bool parseComparison(const std::vector<Expression::Token>& t, size_t& pos, std::string& error);
+
+    // Bits des lignes [begin, begin+count) qui satisfont le prédicat (WORDS mots)
+    void select(const SpotifyDataset& data, size_t begin, size_t count,
+                std::vector<std::vector<double>>& work, std::vector<uint64_t>& stack, uint64_t* bits) const;
+};
@@ -0,0 +1,54 @@
+#include "QueryCache.h"
+
+QueryCache::QueryCache(size_t capacity) : capacity(capacity == 0 ? 1 : capacity) {}
+
+bool QueryCache::get(const std::string& key, uint64_t generation, std::string& out) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = index.find(key);
+    if (it == index.end()) { misses++; return false; }
+    if (it->second->generation != generation) {
+        // Résultat calculé sur un autre état du dataset : obsolète
+        lru.erase(it->second);
+        index.erase(it);
+        misses++;
+        return false;
+    }
+    lru.splice(lru.begin(), lru, it->second);
+    out = it->second->value;
+    hits++;
+    return true;
+}
+
+void QueryCache::put(const std::string& key, uint64_t generation, const std::string& value) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->generation = generation;
+        it->second->value = value;
+        lru.splice(lru.begin(), lru, it->second);
+        return;
+    }
+    lru.push_front(Entry{key, generation, value});
+    index[key] = lru.begin();
+    if (lru.size() > capacity) {
+        index.erase(lru.back().key);
+        lru.pop_back();
+    }
+}
+
+void QueryCache::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    lru.clear();
+    index.clear();
+    hits = misses = 0;
+}
+
+QueryCache::Stats QueryCache::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    Stats s;
+    s.hits = hits;
+    s.misses = misses;
+    s.entries = lru.size();
+    s.capacity = capacity;
+    return s;
+}
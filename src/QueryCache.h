@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+/*
+  QueryCache : cache LRU des résultats de commandes.
+
+  Clé = commande normalisée ; chaque entrée retient la génération du dataset qui l'a
+  produite (SpotifyDataset::generation). Une entrée d'une autre génération est
+  considérée absente et retirée : un rechargement invalide tout sans parcours.
+  Au-delà de 'capacity' entrées, la moins récemment utilisée est évincée.
+  Thread-safe (un mutex autour de chaque opération).
+*/
+class QueryCache {
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t entries = 0;
+        size_t capacity = 0;
+    };
+
+    explicit QueryCache(size_t capacity = 256);
+
+    // true et 'out' rempli si la commande est en cache pour cette génération
+    bool get(const std::string& key, uint64_t generation, std::string& out);
+    void put(const std::string& key, uint64_t generation, const std::string& value);
+    void clear();
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t generation;
+        std::string value;
+    };
+
+    size_t capacity;
+    std::list<Entry> lru; // tête = plus récemment utilisée
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    size_t hits = 0, misses = 0;
+    mutable std::mutex mtx;
+};
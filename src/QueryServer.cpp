@@ -0,0 +1,361 @@
+#include "QueryServer.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+QueryServer::QueryServer(Handler h, unsigned n) : handler(std::move(h)), nbWorkers(n) {
+    if (nbWorkers == 0) nbWorkers = std::thread::hardware_concurrency();
+    if (nbWorkers == 0) nbWorkers = 1;
+}
+
+#ifdef __linux__
+
+// Identifiant rangé dans epoll_event.data.u64 : 0 = socket d'écoute,
+// UINT64_MAX = eventfd de réveil, sinon numéro de connexion (à partir de 1)
+static const uint64_t LISTEN_ID = 0;
+static const uint64_t WAKE_ID = UINT64_MAX;
+
+// Limites mémoire par connexion : une ligne plus longue est refusée (réponse
+// d'erreur puis fermeture) ; au-delà des seuils de réponses en attente ou de
+// commandes en file, la connexion n'est plus lue (EPOLLIN retiré) jusqu'à ce que
+// le client ait consommé ses réponses. Une seule commande étant en cours par
+// connexion, 'out' dépasse le seuil d'au plus un résultat.
+static const size_t MAX_LINE = 64 * 1024;
+static const size_t OUT_HIGH_WATER = 1 << 20;
+static const size_t QUEUE_HIGH_WATER = 64;
+
+// Accept suspendu (plus de descripteurs) : nouvel essai après ce délai sans événement
+static const int ACCEPT_RETRY_MS = 100;
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+QueryServer::~QueryServer() {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(jobMtx);
+        workersStop = true;
+    }
+    jobCv.notify_all();
+    for (std::thread& t : workers) t.join();
+    for (auto& c : conns) close(c.second.fd);
+    if (listenFd >= 0) close(listenFd);
+    if (epollFd >= 0) close(epollFd);
+    if (wakeFd >= 0) close(wakeFd);
+    if (!unixPath.empty()) unlink(unixPath.c_str());
+}
+
+bool QueryServer::setupLoop(std::string& error) {
+    if (!setNonBlocking(listenFd) || listen(listenFd, 128) != 0) {
+        error = std::string("listen: ") + std::strerror(errno);
+        return false;
+    }
+    epollFd = epoll_create1(0);
+    wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (epollFd < 0 || wakeFd < 0) {
+        error = std::string("epoll/eventfd: ") + std::strerror(errno);
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = LISTEN_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.u64 = WAKE_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+    return true;
+}
+
+bool QueryServer::listenUnix(const std::string& path, std::string& error) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        error = "chemin de socket trop long";
+        return false;
+    }
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) { error = std::string("socket: ") + std::strerror(errno); return false; }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    unlink(path.c_str()); // socket laissée par une exécution précédente
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        error = std::string("bind: ") + std::strerror(errno);
+        return false;
+    }
+    unixPath = path;
+    return setupLoop(error);
+}
+
+bool QueryServer::listenTcp(uint16_t port, std::string& error) {
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) { error = std::string("socket: ") + std::strerror(errno); return false; }
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // jamais exposé hors de la machine
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        error = std::string("bind: ") + std::strerror(errno);
+        return false;
+    }
+    return setupLoop(error);
+}
+
+void QueryServer::stop() {
+    stopping = true;
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t r = write(wakeFd, &one, sizeof(one));
+        (void)r;
+    }
+}
+
+void QueryServer::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMtx);
+            jobCv.wait(lock, [this] { return workersStop || !jobs.empty(); });
+            if (workersStop) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        try {
+            job.result = handler(job.command);
+        } catch (const std::exception& e) {
+            job.result = std::string("Erreur : ") + e.what() + "\n";
+        }
+        {
+            std::lock_guard<std::mutex> lock(jobMtx);
+            done.push_back(std::move(job));
+        }
+        uint64_t one = 1;
+        ssize_t r = write(wakeFd, &one, sizeof(one));
+        (void)r;
+    }
+}
+
+void QueryServer::run() {
+    if (epollFd < 0) return;
+    for (unsigned i = 0; i < nbWorkers; ++i)
+        workers.emplace_back([this] { workerLoop(); });
+
+    epoll_event events[64];
+    while (!stopping) {
+        int n = epoll_wait(epollFd, events, 64, acceptPaused ? ACCEPT_RETRY_MS : -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (n == 0 && acceptPaused) setAcceptEnabled(true);
+        for (int i = 0; i < n; ++i) {
+            uint64_t id = events[i].data.u64;
+            if (id == LISTEN_ID) { acceptClients(); continue; }
+            if (id == WAKE_ID) {
+                uint64_t count;
+                ssize_t r = read(wakeFd, &count, sizeof(count));
+                (void)r;
+                collectResults();
+                continue;
+            }
+            if (conns.find(id) == conns.end()) continue; // fermée plus tôt dans ce lot
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                // Socket inutilisable dans les deux sens : aucune réponse ne peut plus
+                // partir, fermeture immédiate (un résultat en cours sera ignoré)
+                closeConnection(id);
+                continue;
+            }
+            if (events[i].events & EPOLLIN) readFrom(id);
+            if (conns.count(id) && (events[i].events & EPOLLOUT)) flush(id);
+        }
+    }
+}
+
+void QueryServer::acceptClients() {
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            // Connexion abandonnée par le client avant accept, ou signal : au suivant
+            if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO) continue;
+            // Plus de descripteurs (ou de mémoire) : la connexion reste en attente et
+            // la socket d'écoute serait signalée en boucle ; on ne l'écoute plus
+            // jusqu'à la prochaine fermeture ou ACCEPT_RETRY_MS
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+                setAcceptEnabled(false);
+            return; // EAGAIN : plus de connexion en attente ; autre erreur : au prochain réveil
+        }
+        setNonBlocking(fd);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // sans effet sur Unix
+        uint64_t id = nextConnId++;
+        Connection& c = conns[id];
+        c.fd = fd;
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+static bool overloaded(const std::string& out, size_t queued) {
+    return out.size() >= OUT_HIGH_WATER || queued >= QUEUE_HIGH_WATER;
+}
+
+// Découpe les lignes complètes de c.in ; false si une ligne dépasse MAX_LINE
+static bool splitLines(std::string& in, std::deque<std::string>& queue) {
+    size_t start = 0, nl;
+    while ((nl = in.find('\n', start)) != std::string::npos) {
+        if (nl - start > MAX_LINE) return false;
+        std::string line = in.substr(start, nl - start);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        queue.push_back(std::move(line));
+        start = nl + 1;
+    }
+    in.erase(0, start);
+    return in.size() <= MAX_LINE;
+}
+
+void QueryServer::readFrom(uint64_t id) {
+    Connection& c = conns[id];
+    char buf[4096];
+    while (!overloaded(c.out, c.queue.size())) {
+        ssize_t r = read(c.fd, buf, sizeof(buf));
+        if (r > 0) {
+            c.in.append(buf, (size_t)r);
+            if (!splitLines(c.in, c.queue)) {
+                // Les commandes en file sont abandonnées : l'erreur est la dernière réponse
+                std::string error = "Erreur : ligne de plus de " + std::to_string(MAX_LINE) + " octets\n";
+                c.queue.clear();
+                c.out += "OK " + std::to_string(error.size()) + "\n" + error;
+                ssize_t w = send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL); // au mieux
+                (void)w;
+                // Fermer avec des octets non lus enverrait un RST qui effacerait la
+                // réponse côté client : on vide d'abord ce qui est déjà arrivé (borné)
+                shutdown(c.fd, SHUT_WR);
+                for (int k = 0; k < 256 && read(c.fd, buf, sizeof(buf)) > 0; ++k) {}
+                closeConnection(id);
+                return;
+            }
+            continue;
+        }
+        if (r == 0) c.peerClosed = true;
+        else if (errno != EAGAIN && errno != EWOULDBLOCK) c.peerClosed = true;
+        break;
+    }
+
+    dispatchNext(id);
+    if (c.peerClosed && !c.busy && c.queue.empty() && c.out.empty()) closeConnection(id);
+    // Après une fin de lecture, read() renverrait 0 à chaque réveil ; en surcharge,
+    // le client attend que ses réponses soient lues : dans les deux cas, plus de EPOLLIN
+    else if (c.peerClosed || overloaded(c.out, c.queue.size())) updateInterest(id);
+}
+
+// Envoie la commande suivante de la connexion à un worker (une seule à la fois)
+void QueryServer::dispatchNext(uint64_t id) {
+    Connection& c = conns[id];
+    if (c.busy || c.queue.empty()) return;
+    c.busy = true;
+    Job job;
+    job.conn = id;
+    job.command = std::move(c.queue.front());
+    c.queue.pop_front();
+    {
+        std::lock_guard<std::mutex> lock(jobMtx);
+        jobs.push_back(std::move(job));
+    }
+    jobCv.notify_one();
+}
+
+void QueryServer::collectResults() {
+    std::deque<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(jobMtx);
+        ready.swap(done);
+    }
+    for (Job& job : ready) {
+        auto it = conns.find(job.conn);
+        if (it == conns.end()) continue; // client parti entre-temps
+        Connection& c = it->second;
+        c.busy = false;
+        c.out += "OK " + std::to_string(job.result.size()) + "\n";
+        c.out += job.result;
+        dispatchNext(job.conn); // avant flush : updateInterest voit la file à jour
+        flush(job.conn);
+    }
+}
+
+void QueryServer::flush(uint64_t id) {
+    Connection& c = conns[id];
+    while (!c.out.empty()) {
+        ssize_t w = send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL);
+        if (w > 0) { c.out.erase(0, (size_t)w); continue; }
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        closeConnection(id); // erreur d'écriture : client injoignable
+        return;
+    }
+    if (c.out.empty() && c.peerClosed && !c.busy && c.queue.empty()) {
+        closeConnection(id);
+        return;
+    }
+    updateInterest(id);
+}
+
+// EPOLLIN tant que le pair peut encore envoyer (après une fin de lecture, il
+// resterait signalé en permanence) et que la connexion n'est pas en surcharge ;
+// EPOLLOUT tant qu'il reste des octets à envoyer.
+void QueryServer::updateInterest(uint64_t id) {
+    Connection& c = conns[id];
+    bool reading = !c.peerClosed && !overloaded(c.out, c.queue.size());
+    epoll_event ev{};
+    ev.events = (reading ? (uint32_t)(EPOLLIN | EPOLLRDHUP) : 0u) | (c.out.empty() ? 0u : (uint32_t)EPOLLOUT);
+    ev.data.u64 = id;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+}
+
+void QueryServer::closeConnection(uint64_t id) {
+    auto it = conns.find(id);
+    if (it == conns.end()) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    conns.erase(it);
+    if (acceptPaused) setAcceptEnabled(true); // un descripteur vient de se libérer
+}
+
+void QueryServer::setAcceptEnabled(bool enabled) {
+    acceptPaused = !enabled;
+    epoll_event ev{};
+    ev.events = enabled ? EPOLLIN : 0u;
+    ev.data.u64 = LISTEN_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, listenFd, &ev);
+}
+
+#else // !__linux__
+
+QueryServer::~QueryServer() {}
+
+bool QueryServer::listenUnix(const std::string&, std::string& error) {
+    error = "mode serveur disponible uniquement sous Linux (epoll, build MakeFile.sh)";
+    return false;
+}
+
+bool QueryServer::listenTcp(uint16_t, std::string& error) {
+    error = "mode serveur disponible uniquement sous Linux (epoll, build MakeFile.sh)";
+    return false;
+}
+
+void QueryServer::run() {}
+void QueryServer::stop() { stopping = true; }
+
+#endif
@@ -0,0 +1,97 @@
+#pragma once
+#include <string>
+#include <functional>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+/*
+  QueryServer : serveur local de commandes (Linux : epoll).
+
+  Protocole : le client envoie une commande par ligne ('\n'). Pour chaque ligne,
+  le serveur répond "OK <taille>\n" suivi de <taille> octets de résultat, dans
+  l'ordre des requêtes de la connexion (les requêtes peuvent être enchaînées sans
+  attendre les réponses).
+
+  Un seul thread gère les sockets (accept, lecture, écriture non bloquantes) ;
+  les commandes sont exécutées par un groupe de workers, chacune par un appel au
+  handler, qui doit donc supporter des appels concurrents. Une connexion n'a
+  qu'une commande en cours à la fois ; les suivantes attendent dans sa file.
+  Une ligne de plus de 64 Kio reçoit une réponse d'erreur puis la connexion est
+  fermée ; une connexion dont les réponses ou la file s'accumulent n'est plus lue
+  tant que le client ne lit pas ses réponses.
+
+  Écoute sur une socket Unix (chemin) ou en TCP sur 127.0.0.1 uniquement.
+  Linux uniquement : le serveur et son client sont construits par MakeFile.sh ;
+  ailleurs (build Windows MakeFile.bat), listen* renvoient false avec un message.
+*/
+class QueryServer {
+public:
+    using Handler = std::function<std::string(const std::string& command)>;
+
+    // nbWorkers = 0 -> std::thread::hardware_concurrency()
+    explicit QueryServer(Handler handler, unsigned nbWorkers = 0);
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    // Ouvre la socket d'écoute. 'error' décrit l'échec éventuel.
+    bool listenUnix(const std::string& path, std::string& error);
+    bool listenTcp(uint16_t port, std::string& error);
+
+    // Boucle d'événements ; rend la main après stop() (appelable depuis un autre thread)
+    void run();
+    void stop();
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string in;                // octets reçus pas encore découpés en lignes
+        std::string out;               // réponses pas encore envoyées
+        std::deque<std::string> queue; // commandes en attente
+        bool busy = false;             // une commande est chez un worker
+        bool peerClosed = false;       // fin de lecture : fermer après les réponses
+    };
+    struct Job {
+        uint64_t conn;
+        std::string command;
+        std::string result;
+    };
+
+    Handler handler;
+    unsigned nbWorkers;
+    std::vector<std::thread> workers;
+
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;   // eventfd : réveille la boucle (résultat prêt ou stop)
+    std::string unixPath;
+    std::atomic<bool> stopping{false};
+
+    std::unordered_map<uint64_t, Connection> conns; // accédé par la seule boucle
+    uint64_t nextConnId = 1;
+    bool acceptPaused = false;  // plus de descripteurs : socket d'écoute plus surveillée
+
+    std::mutex jobMtx;
+    std::condition_variable jobCv;
+    std::deque<Job> jobs;     // à exécuter
+    std::deque<Job> done;     // exécutés, à renvoyer (protégé par jobMtx)
+    bool workersStop = false;
+
+    bool setupLoop(std::string& error);
+    void workerLoop();
+    void acceptClients();
+    void readFrom(uint64_t id);
+    void flush(uint64_t id);
+    void updateInterest(uint64_t id);
+    void dispatchNext(uint64_t id);
+    void collectResults();
+    void closeConnection(uint64_t id);
+    void setAcceptEnabled(bool enabled);
+};
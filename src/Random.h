@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+
+/*
+  Random : générateur pseudo-aléatoire rapide (xoshiro256**), graine étendue par splitmix64.
+
+  Une instance par tâche ou par réplicat : pas d'état partagé entre threads. Deux
+  instances créées avec la même graine produisent la même suite, ce qui rend les
+  rééchantillonnages reproductibles quel que soit le nombre de threads.
+*/
+class Random {
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    static uint64_t splitMix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    explicit Random(uint64_t seed) {
+        for (uint64_t& w : s) w = splitMix64(seed);
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Entier dans [0, n) par multiplication (Lemire), sans division ; n < 2^32
+    uint32_t below(uint32_t n) {
+        return (uint32_t)(((next() >> 32) * (uint64_t)n) >> 32);
+    }
+
+    // Réel uniforme dans [0, 1)
+    double uniform() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
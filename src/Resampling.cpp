@@ -0,0 +1,194 @@
+#include "Resampling.h"
+#include "Random.h"
+#include "StatDesc.h"
+#include "StatInfer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+bool Resampling::parseStatistic(const std::string& name, Statistic& stat) {
+    if (name == "mean") stat = Statistic::Mean;
+    else if (name == "median") stat = Statistic::Median;
+    else if (name == "pearson") stat = Statistic::Pearson;
+    else if (name == "slope") stat = Statistic::Slope;
+    else return false;
+    return true;
+}
+
+int Resampling::arity(Statistic stat) {
+    return (stat == Statistic::Pearson || stat == Statistic::Slope) ? 2 : 1;
+}
+
+// --- REPLICATS ---
+// Chaque fonction tire n indices avec remise et renvoie la statistique du réplicat.
+
+static double replicateMean(ColumnView x, Random& rng) {
+    size_t n = x.size();
+    double s = 0.0;
+    for (size_t i = 0; i < n; ++i) s += x[rng.below((uint32_t)n)];
+    return s / n;
+}
+
+// Tirer une ligne au hasard revient à tirer une position dans la colonne triée :
+// on compte les tirages par position (counts réutilisé d'un réplicat à l'autre) puis
+// on cumule jusqu'aux statistiques d'ordre centrales. O(n) sans tri par réplicat.
+static double replicateMedian(const std::vector<double>& sorted, std::vector<uint32_t>& counts, Random& rng) {
+    size_t n = sorted.size();
+    std::fill(counts.begin(), counts.end(), 0);
+    for (size_t i = 0; i < n; ++i) counts[rng.below((uint32_t)n)]++;
+
+    size_t k1 = (n - 1) / 2, k2 = n / 2; // rangs (0-based) des éléments centraux
+    double v1 = 0.0, v2 = 0.0;
+    size_t cum = 0;
+    for (size_t p = 0; p < n; ++p) {
+        if (counts[p] == 0) continue;
+        size_t next = cum + counts[p];
+        if (k1 >= cum && k1 < next) v1 = sorted[p];
+        if (k2 >= cum && k2 < next) { v2 = sorted[p]; break; }
+        cum = next;
+    }
+    return (v1 + v2) / 2.0;
+}
+
+// Sommes des écarts à un pivot (moyennes de l'échantillon complet) : un seul passage
+// sans perte de précision notable, puis co-moments centrés du réplicat.
+static double replicateCross(ColumnView x, ColumnView y, double px, double py, bool slope, Random& rng) {
+    size_t n = x.size();
+    double sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t r = rng.below((uint32_t)n);
+        double dx = x[r] - px, dy = y[r] - py;
+        sx += dx; sy += dy;
+        sxx += dx * dx; syy += dy * dy; sxy += dx * dy;
+    }
+    double cxx = sxx - sx * sx / n;
+    double cyy = syy - sy * sy / n;
+    double cxy = sxy - sx * sy / n;
+    if (slope) return (cxx <= 0) ? 0.0 : cxy / cxx;
+    if (cxx <= 0 || cyy <= 0) return 0.0;
+    return cxy / std::sqrt(cxx * cyy);
+}
+
+// --- BOOTSTRAP ---
+Resampling::Interval Resampling::bootstrap(Statistic stat, ColumnView x, ColumnView y, size_t replicates,
+                                           double alpha, uint64_t seed) {
+    Interval res;
+    size_t n = x.size();
+    bool twoCols = (arity(stat) == 2);
+    if (n == 0 || replicates == 0 || (twoCols && y.size() != n)) return res;
+
+    // Statistique sur l'échantillon complet et préparation partagée (lecture seule)
+    std::vector<double> sorted;
+    double px = 0.0, py = 0.0;
+    switch (stat) {
+    case Statistic::Mean:
+        res.estimate = StatDesc::mean(x);
+        break;
+    case Statistic::Median:
+        res.estimate = StatDesc::median(x);
+        sorted = x.toVector();
+        std::sort(sorted.begin(), sorted.end());
+        break;
+    case Statistic::Pearson:
+        res.estimate = StatInfer::pearson(x, y);
+        px = StatDesc::mean(x); py = StatDesc::mean(y);
+        break;
+    case Statistic::Slope: {
+        double a, b, r2;
+        StatInfer::regressionLineaire(x, y, a, b, r2);
+        res.estimate = a;
+        px = StatDesc::mean(x); py = StatDesc::mean(y);
+        break;
+    }
+    }
+
+    std::vector<double> values(replicates);
+    size_t nbBatches = (replicates + BATCH - 1) / BATCH;
+    ThreadPool::global().parallelFor(nbBatches, [&](size_t b) {
+        std::vector<uint32_t> counts;                 // tampon propre au lot
+        if (stat == Statistic::Median) counts.resize(n);
+        size_t end = std::min(replicates, (b + 1) * BATCH);
+        for (size_t r = b * BATCH; r < end; ++r) {
+            Random rng(seed + r);
+            switch (stat) {
+            case Statistic::Mean:    values[r] = replicateMean(x, rng); break;
+            case Statistic::Median:  values[r] = replicateMedian(sorted, counts, rng); break;
+            case Statistic::Pearson: values[r] = replicateCross(x, y, px, py, false, rng); break;
+            case Statistic::Slope:   values[r] = replicateCross(x, y, px, py, true, rng); break;
+            }
+        }
+    });
+
+    std::vector<double> q = StatDesc::quantiles(values, {alpha / 2.0, 1.0 - alpha / 2.0});
+    res.lower = q[0];
+    res.upper = q[1];
+    res.replicates = replicates;
+    return res;
+}
+
+// --- TEST DE PERMUTATION ---
+// Sous H0, les étiquettes a/b sont échangeables. Une permutation = mélange de Fisher-Yates
+// partiel qui place n1 valeurs tirées au hasard en tête du tampon ; comme la somme
+// totale est fixe, la différence des moyennes ne demande que la somme de ces n1 valeurs.
+// Chaque lot garde son tampon (copie unique des données groupées) d'une permutation à
+// l'autre : un mélange appliqué à n'importe quel ordre de départ reste uniforme.
+Resampling::PermutationTest Resampling::permutationTest(ColumnView a, ColumnView b, size_t maxPermutations,
+                                                        double alpha, uint64_t seed) {
+    PermutationTest res;
+    size_t n1 = a.size(), n2 = b.size(), n = n1 + n2;
+    if (n1 == 0 || n2 == 0 || maxPermutations == 0) return res;
+
+    std::vector<double> pooled;
+    pooled.reserve(n);
+    pooled.insert(pooled.end(), a.begin(), a.end());
+    pooled.insert(pooled.end(), b.begin(), b.end());
+    double total = 0.0;
+    for (double v : pooled) total += v;
+    double sumA = 0.0;
+    for (double v : a) sumA += v;
+    res.observed = sumA / n1 - (total - sumA) / n2;
+    // Tolérance relative : une permutation qui redonne le même partage doit compter
+    double threshold = std::fabs(res.observed) * (1.0 - 1e-12);
+
+    size_t nbBatches = (maxPermutations + BATCH - 1) / BATCH;
+    std::vector<std::vector<double>> buffers(PERM_ROUND); // tampons réutilisés de tour en tour
+    std::vector<size_t> exceed(PERM_ROUND);
+    size_t done = 0, totalExceed = 0;
+
+    for (size_t first = 0; first < nbBatches; first += PERM_ROUND) {
+        size_t inRound = std::min(PERM_ROUND, nbBatches - first);
+        ThreadPool::global().parallelFor(inRound, [&](size_t k) {
+            size_t batch = first + k;
+            std::vector<double>& buf = buffers[k];
+            buf.assign(pooled.begin(), pooled.end());
+            Random rng(seed + batch);
+            size_t end = std::min(maxPermutations, (batch + 1) * BATCH);
+            size_t count = 0;
+            for (size_t p = batch * BATCH; p < end; ++p) {
+                double s = 0.0;
+                for (size_t i = 0; i < n1; ++i) {
+                    size_t j = i + rng.below((uint32_t)(n - i));
+                    std::swap(buf[i], buf[j]);
+                    s += buf[i];
+                }
+                double diff = s / n1 - (total - s) / n2;
+                if (std::fabs(diff) >= threshold) count++;
+            }
+            exceed[k] = count;
+        });
+        for (size_t k = 0; k < inRound; ++k) totalExceed += exceed[k];
+        done = std::min(maxPermutations, (first + inRound) * BATCH);
+
+        // Arrêt séquentiel : décision acquise quand alpha est loin de l'estimation
+        double p = (totalExceed + 1.0) / (done + 1.0);
+        double se = std::sqrt(p * (1.0 - p) / done);
+        if (done < maxPermutations && std::fabs(p - alpha) > 4.0 * se) {
+            res.earlyStop = true;
+            break;
+        }
+    }
+
+    res.permutations = done;
+    res.pValue = (totalExceed + 1.0) / (done + 1.0);
+    return res;
+}
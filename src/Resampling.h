@@ -0,0 +1,55 @@
+#pragma once
+#include "ColumnView.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+  Resampling : méthodes de rééchantillonnage (bootstrap, test de permutation).
+
+  Les réplicats tirent des indices de lignes (aucune copie de colonne par réplicat)
+  et sont répartis par lots fixes sur ThreadPool::global(). Chaque réplicat (bootstrap)
+  ou chaque lot (permutation) a son propre générateur dérivé de la graine : le résultat
+  ne dépend que de la graine, pas du nombre de threads.
+*/
+class Resampling {
+public:
+    enum class Statistic { Mean, Median, Pearson, Slope };
+
+    struct Interval {
+        double estimate = 0.0;   // statistique sur l'échantillon complet
+        double lower = 0.0;
+        double upper = 0.0;
+        size_t replicates = 0;
+    };
+
+    static constexpr uint64_t DEFAULT_SEED = 0x5EEDULL;
+    static constexpr size_t BATCH = 16; // réplicats par tâche du pool
+
+    // "mean" | "median" | "pearson" | "slope"
+    static bool parseStatistic(const std::string& name, Statistic& stat);
+    // Nombre de colonnes attendues (1 pour mean/median, 2 pour pearson/slope)
+    static int arity(Statistic stat);
+
+    struct PermutationTest {
+        double observed = 0.0;   // moyenne(a) - moyenne(b)
+        double pValue = 1.0;     // bilatérale, (exces + 1) / (permutations + 1)
+        size_t permutations = 0; // permutations réellement effectuées
+        bool earlyStop = false;  // arrêt avant maxPermutations (décision acquise)
+    };
+
+    static constexpr size_t PERM_ROUND = 8; // lots par tour avant le test d'arrêt
+
+    // Test de permutation sur la différence des moyennes de a et b : les étiquettes
+    // de groupe sont rebattues au plus maxPermutations fois. Les permutations sont faites
+    // par tours de PERM_ROUND lots parallèles ; après chaque tour, on s'arrête si
+    // la p-value estimée est à plus de 4 erreurs-types de alpha (Monte-Carlo séquentiel).
+    static PermutationTest permutationTest(ColumnView a, ColumnView b, size_t maxPermutations,
+                                           double alpha = 0.05, uint64_t seed = DEFAULT_SEED);
+
+    // IC bootstrap par percentiles, niveau 1-alpha. y n'est utilisé que pour
+    // Pearson (corrélation x,y) et Slope (pente de la régression de y sur x).
+    static Interval bootstrap(Statistic stat, ColumnView x, ColumnView y, size_t replicates,
+                              double alpha = 0.05, uint64_t seed = DEFAULT_SEED);
+};
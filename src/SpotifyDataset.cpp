@@ -1,13 +1,23 @@
 #include "SpotifyDataset.h"
-#include <fstream>
-#include <sstream>
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "Parallel.h"
 #include <iostream>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdint>
 #include <algorithm>
+#include <charconv>
+#include <stdexcept>
 #include <cctype>
+#include <atomic>
+#include <cmath>
 
 // ----------- Helpers -----------
 
-std::string SpotifyDataset::trim(const std::string& s) {
+std::string_view SpotifyDataset::trim(std::string_view s) {
     auto is_space = [](unsigned char c) {
         return std::isspace(c) || c == '\r' || c == '\n';
     };
@@ -17,7 +27,7 @@ std::string SpotifyDataset::trim(const std::string& s) {
     return s.substr(b, e - b);
 }
 
-std::string SpotifyDataset::normalizeKey(const std::string& s) {
+std::string SpotifyDataset::normalizeKey(std::string_view s) {
     std::string out;
     out.reserve(s.size());
     for (unsigned char c : s) {
@@ -28,35 +38,65 @@ std::string SpotifyDataset::normalizeKey(const std::string& s) {
 }
 
 // Parser CSV conforme RFC 4180 (guillemets, "" -> ").
-std::vector<std::string> SpotifyDataset::parseCSVLine(const std::string& line) {
-    std::vector<std::string> fields;
-    std::string cur;
-    bool inQuotes = false;
+// Les champs sont des vues sur la ligne d'origine : cas courant sans guillemet ou
+// entièrement entre guillemets ("85,041.3") -> aucune copie. Seuls les champs avec
+// guillemets internes sont reconstruits dans 'scratch' (réservé à la taille de la
+// ligne, donc jamais réalloué pendant le découpage : les vues restent valides).
+void SpotifyDataset::parseCSVLine(std::string_view line, std::vector<std::string_view>& fields, std::string& scratch) {
+    fields.clear();
+    scratch.clear();
+    scratch.reserve(line.size());
+
+    auto finishField = [&](size_t b, size_t e, bool hasQuote) {
+        std::string_view raw = trim(line.substr(b, e - b));
+        if (!hasQuote) { fields.push_back(raw); return; }
+
+        // Champ entièrement entre guillemets, sans guillemet interne
+        if (raw.size() >= 2 && raw.front() == '"' && raw.back() == '"') {
+            std::string_view inner = raw.substr(1, raw.size() - 2);
+            if (inner.find('"') == std::string_view::npos) { fields.push_back(trim(inner)); return; }
+        }
 
+        // Cas général : on rejoue la machine à états d'origine dans le tampon
+        size_t from = scratch.size();
+        bool inQuotes = false;
+        for (size_t i = b; i < e; ++i) {
+            char ch = line[i];
+            if (ch == '"') {
+                if (inQuotes && i + 1 < e && line[i + 1] == '"') {
+                    // guillemet échappé
+                    scratch.push_back('"');
+                    ++i;
+                } else {
+                    inQuotes = !inQuotes;
+                }
+            } else {
+                scratch.push_back(ch);
+            }
+        }
+        fields.push_back(trim(std::string_view(scratch).substr(from)));
+    };
+
+    size_t fieldStart = 0;
+    bool inQuotes = false, hasQuote = false;
     for (size_t i = 0; i < line.size(); ++i) {
         char ch = line[i];
         if (ch == '"') {
-            if (inQuotes && i + 1 < line.size() && line[i + 1] == '"') {
-                // guillemet échappé
-                cur.push_back('"');
-                ++i;
-            } else {
-                inQuotes = !inQuotes;
-            }
+            hasQuote = true;
+            if (inQuotes && i + 1 < line.size() && line[i + 1] == '"') ++i; // guillemet échappé
+            else inQuotes = !inQuotes;
         } else if (ch == ',' && !inQuotes) {
-            fields.push_back(trim(cur));
-            cur.clear();
-        } else {
-            cur.push_back(ch);
+            finishField(fieldStart, i, hasQuote);
+            fieldStart = i + 1;
+            hasQuote = false;
         }
     }
-    fields.push_back(trim(cur));
-    return fields;
+    finishField(fieldStart, line.size(), hasQuote);
 }
 
 // Mappe les colonnes depuis la première ligne si c'est un header.
 // Heuristique: si >=3 noms reconnus, on considère que c'est un header.
-SpotifyDataset::ColMap SpotifyDataset::buildColumnMap(const std::vector<std::string>& firstRow, bool& isHeader) {
+SpotifyDataset::ColMap SpotifyDataset::buildColumnMap(const std::vector<std::string_view>& firstRow, bool& isHeader) {
     ColMap map;
     int recognized = 0;
     for (int i = 0; i < (int)firstRow.size(); ++i) {
@@ -75,104 +115,118 @@ SpotifyDataset::ColMap SpotifyDataset::buildColumnMap(const std::vector<std::str
 
 // ----------- Parsing numérique-----------
 
-double SpotifyDataset::parseNumber(const std::string& s, int linenumber) const {
-    std::string sanitized = trim(s);
+// Les séparateurs sont retirés dans un tampon local (pas d'allocation), puis
+// la conversion se fait avec std::from_chars.
+double SpotifyDataset::parseNumber(std::string_view s, int linenumber, std::ostream& log) {
+    std::string_view trimmed = trim(s);
 
     // Valeur vide -> on retourne 0.0 
-    if (sanitized.empty()) return 0.0;
+    if (trimmed.empty()) return 0.0;
 
-    // Retirer les espaces internes typiques de groupement "60 000"
-    sanitized.erase(std::remove_if(sanitized.begin(), sanitized.end(),
-        [](unsigned char c){ return c==' ' || c=='\t'; }), sanitized.end());
+    char buf[128];
+    if (trimmed.size() >= sizeof(buf)) {
+        log << "Erreur à la ligne " << linenumber << ": Valeur non numérique : '" << s << "'\n";
+        throw std::invalid_argument("parseNumber");
+    }
 
-    bool hasDot = sanitized.find('.') != std::string::npos;
-    bool hasComma = sanitized.find(',') != std::string::npos;
+    // Retirer les espaces internes typiques de groupement "60 000"
+    size_t n = 0;
+    int nbComma = 0;
+    bool hasDot = false;
+    for (char c : trimmed) {
+        if (c == ' ' || c == '\t') continue;
+        if (c == ',') nbComma++;
+        if (c == '.') hasDot = true;
+        buf[n++] = c;
+    }
 
-    if (hasComma && !hasDot) {
-        // S'il n'y a qu'une virgule et aucun point: on suppose virgule décimale
-        if (std::count(sanitized.begin(), sanitized.end(), ',') == 1) {
-            std::replace(sanitized.begin(), sanitized.end(), ',', '.');
-        } else {
-            // Plusieurs virgules: on suppose séparateurs de milliers -> on les enlève
-            sanitized.erase(std::remove(sanitized.begin(), sanitized.end(), ','), sanitized.end());
+    if (nbComma > 0) {
+        // S'il n'y a qu'une virgule et aucun point: on suppose virgule décimale.
+        // Sinon (plusieurs virgules, ou virgule + point): séparateurs de milliers -> on les enlève
+        bool decimalComma = (nbComma == 1 && !hasDot);
+        size_t w = 0;
+        for (size_t r = 0; r < n; ++r) {
+            if (buf[r] != ',') buf[w++] = buf[r];
+            else if (decimalComma) buf[w++] = '.';
         }
-    } else if (hasComma && hasDot) {
-        // Les virgules sont probablement des séparateurs de milliers
-        sanitized.erase(std::remove(sanitized.begin(), sanitized.end(), ','), sanitized.end());
+        n = w;
     }
     // Sinon: ni virgule ni point -> entier "pur"
 
-    try {
-        size_t idx = 0;
-        double val = std::stod(sanitized, &idx);
-        // Vérifier qu'il n'y a pas de traînant non numérique significatif
-        if (idx < sanitized.size()) {
-            // caractères restants -> log et exception
-            std::cerr << "Avertissement ligne " << linenumber
-                      << ": caractères inattendus dans '" << s << "'\n";
-        }
-        return val;
-    } catch (const std::exception&) {
-        std::cerr << "Erreur à la ligne " << linenumber << ": Valeur non numérique : '" << s << "'\n";
-        throw;
+    // std::from_chars n'accepte pas le '+' initial (contrairement à std::stod)
+    const char* first = buf;
+    const char* last = buf + n;
+    if (first != last && *first == '+') ++first;
+
+    double val = 0.0;
+    auto res = std::from_chars(first, last, val);
+    if (res.ec != std::errc()) {
+        log << "Erreur à la ligne " << linenumber << ": Valeur non numérique : '" << s << "'\n";
+        throw std::invalid_argument("parseNumber");
+    }
+    // from_chars accepte "nan" et "inf" : valeurs refusées, les colonnes restent finies
+    if (!std::isfinite(val)) {
+        log << "Erreur à la ligne " << linenumber << ": Valeur non finie : '" << s << "'\n";
+        throw std::invalid_argument("parseNumber");
     }
+    // Vérifier qu'il n'y a pas de traînant non numérique significatif
+    if (res.ptr != last) {
+        log << "Avertissement ligne " << linenumber
+                  << ": caractères inattendus dans '" << s << "'\n";
+    }
+    return val;
 }
 
 // ----------- Chargement du CSV -----------
 
-bool SpotifyDataset::loadFromCSV(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) return false;
-
-    artists.clear();
-
-    std::string line;
-    int lineNumber = 0;
-    int imported = 0, skipped = 0;
+// Les diagnostics vont dans 'log' (flux de l'appelant en séquentiel, tampon propre au morceau
+// en parallèle).
+bool SpotifyDataset::extractRow(const std::vector<std::string_view>& row, int lineno, const ColMap& map, std::ostream& log,
+                                std::string_view& name, double values[NB_ATTRIBUTES]) {
+    auto safeGet = [&](int idx) -> std::string_view {
+        return (idx >= 0 && idx < (int)row.size()) ? row[idx] : std::string_view();
+    };
 
-    auto processRow = [&](const std::vector<std::string>& row, int lineno, const ColMap& map) -> bool {
-        auto safeGet = [&](int idx) -> std::string {
-            return (idx >= 0 && idx < (int)row.size()) ? row[idx] : std::string();
-        };
+    // Champs requis minimaux: nom + toutes les colonnes numériques
+    if (!map.complete()) {
+        log << "Ligne " << lineno << " ignorée: mapping de colonnes incomplet\n";
+        return false;
+    }
 
-        // Champs requis minimaux: nom + toutes les colonnes numériques
-        if (map.artist < 0 || map.streams < 0 || map.daily < 0 ||
-            map.asLead < 0 || map.solo < 0 || map.asFeature < 0) {
-            std::cerr << "Ligne " << lineno << " ignorée: mapping de colonnes incomplet\n";
+    try {
+        name = trim(safeGet(map.artist));
+        if (name.empty()) {
+            log << "Ligne " << lineno << " ignorée: nom d'artiste vide\n";
             return false;
         }
 
-        try {
-            std::string name = trim(safeGet(map.artist));
-            if (name.empty()) {
-                std::cerr << "Ligne " << lineno << " ignorée: nom d'artiste vide\n";
-                return false;
-            }
+        values[(int)Attribute::Streams]   = parseNumber(safeGet(map.streams), lineno, log);
+        values[(int)Attribute::Daily]     = parseNumber(safeGet(map.daily), lineno, log);
+        values[(int)Attribute::AsLead]    = parseNumber(safeGet(map.asLead), lineno, log);
+        values[(int)Attribute::Solo]      = parseNumber(safeGet(map.solo), lineno, log);
+        values[(int)Attribute::AsFeature] = parseNumber(safeGet(map.asFeature), lineno, log);
+        return true;
+    } catch (...) {
+        // parseNumber a déjà loggé; on ignore la ligne
+        return false;
+    }
+}
 
-            double streams   = parseNumber(safeGet(map.streams), lineno);
-            double daily     = parseNumber(safeGet(map.daily), lineno);
-            double asLead    = parseNumber(safeGet(map.asLead), lineno);
-            double solo      = parseNumber(safeGet(map.solo), lineno);
-            double asFeature = parseNumber(safeGet(map.asFeature), lineno);
+// Première ligne : header reconnu -> mapping par noms ; sinon mapping par positions
+// fixes et la ligne est traitée comme une donnée. Renvoie le corps (lignes suivantes).
+template <class OnRow>
+std::string_view SpotifyDataset::parseFirstLine(std::string_view buffer, ColMap& map, std::ostream& log, ParseStats& stats, OnRow&& onRow) {
+    size_t nl = buffer.find('\n');
+    if (nl == std::string_view::npos) nl = buffer.size();
+    std::string_view line = buffer.substr(0, nl);
+    const int lineNumber = 1;
 
-            artists.emplace_back(name, streams, daily, asLead, solo, asFeature);
-            return true;
-        } catch (...) {
-            // parseNumber a déjà loggé; on ignore la ligne
-            return false;
-        }
-    };
-
-    // Lire première ligne
-    if (!std::getline(file, line)) {
-        std::cerr << "Fichier vide.\n";
-        return true; // fichier ouvert mais vide
-    }
-    lineNumber++;
-    auto firstRow = parseCSVLine(line);
+    std::vector<std::string_view> row;
+    std::string scratch;
+    parseCSVLine(line, row, scratch);
 
     bool isHeader = false;
-    ColMap map = buildColumnMap(firstRow, isHeader);
+    map = buildColumnMap(row, isHeader);
 
     // Fallback: si pas header, mapping par positions fixes
     if (!isHeader) {
@@ -184,59 +238,563 @@ bool SpotifyDataset::loadFromCSV(const std::string& filename) {
         map.asFeature = 5;
 
         // Traiter la première ligne comme données
-        if ((int)firstRow.size() >= 6) {
-            if (processRow(firstRow, lineNumber, map)) imported++; else skipped++;
+        if ((int)row.size() >= 6) {
+            std::string_view name;
+            double values[NB_ATTRIBUTES];
+            if (extractRow(row, lineNumber, map, log, name, values)) { onRow(name, values); stats.imported++; }
+            else stats.skipped++;
         } else {
-            std::cerr << "Ligne " << lineNumber << " ignorée: nombre de colonnes insuffisant (" << firstRow.size() << ")\n";
-            skipped++;
-        }
-    } else {
-        // Header: si mapping incomplet, on tentera quand même par positions fixes en secours
-        if (!map.complete()) {
-            ColMap pos;
-            pos.artist = 0; pos.streams = 1; pos.daily = 2; pos.asLead = 3; pos.solo = 4; pos.asFeature = 5;
-            // On utilisera 'map' pour l'accès par nom; si une colonne manque (=-1), on essaiera 'pos'
-            // en fusionnant dynamiquement dans processRow on garde 'map' tel quel
+            log << "Ligne " << lineNumber << " ignorée: nombre de colonnes insuffisant (" << row.size() << ")\n";
+            stats.skipped++;
         }
+    } else if (!map.complete()) {
+        // Header reconnu mais incomplet : les lignes seront ignorées, on dit pourquoi une fois
+        log << "En-tête incomplet, colonne(s) manquante(s) :";
+        if (map.artist < 0) log << " artist";
+        if (map.streams < 0) log << " streams";
+        if (map.daily < 0) log << " daily";
+        if (map.asLead < 0) log << " aslead";
+        if (map.solo < 0) log << " solo";
+        if (map.asFeature < 0) log << " asfeature";
+        log << '\n';
     }
+    return buffer.substr(std::min(buffer.size(), nl + 1));
+}
+
+// Analyse toutes les lignes de 'text' (la première porte le numéro firstLine) et
+// appelle onRow(nom, valeurs) pour chaque ligne valide.
+template <class OnRow>
+void SpotifyDataset::forEachRow(std::string_view text, int firstLine, const ColMap& map, std::ostream& log, ParseStats& stats, OnRow&& onRow) {
+    // Tampons réutilisés pour toutes les lignes
+    std::vector<std::string_view> row;
+    std::string scratch;
+    std::string_view name;
+    double values[NB_ATTRIBUTES];
+    int lineNumber = firstLine - 1;
+    size_t pos = 0;
+
+    while (pos < text.size()) {
+        size_t nl = text.find('\n', pos);
+        if (nl == std::string_view::npos) nl = text.size();
+        std::string_view line = text.substr(pos, nl - pos);
+        pos = nl + 1;
 
-    // Parcours des lignes restantes
-    while (std::getline(file, line)) {
         lineNumber++;
-        auto row = parseCSVLine(line);
+        parseCSVLine(line, row, scratch);
 
-        // Si la ligne est visiblement vide
+        // Si la ligne est visiblement vide (les champs sont déjà trimés)
         bool allEmpty = true;
-        for (auto& f : row) { if (!trim(f).empty()) { allEmpty = false; break; } }
+        for (auto f : row) { if (!f.empty()) { allEmpty = false; break; } }
         if (allEmpty) continue;
 
         if ((int)row.size() < 2) { // moins que 2 colonnes -> clairement corrompue
-            std::cerr << "Ligne " << lineNumber << " ignorée: trop peu de colonnes (" << row.size() << ")\n";
-            skipped++; continue;
+            log << "Ligne " << lineNumber << " ignorée: trop peu de colonnes (" << row.size() << ")\n";
+            stats.skipped++; continue;
+        }
+
+        if (!extractRow(row, lineNumber, map, log, name, values)) { stats.skipped++; continue; }
+        onRow(name, values);
+        stats.imported++;
+    }
+}
+
+void SpotifyDataset::parseRows(std::string_view text, int firstLine, const ColMap& map, std::ostream& log, ParseStats& stats) {
+    forEachRow(text, firstLine, map, log, stats,
+               [this](std::string_view name, const double* values) { addRow(name, values); });
+}
+
+// Découpage parallèle : le corps du fichier est coupé en plages d'octets dont les
+// bornes sont avancées jusqu'au '\n' suivant. parseCSVLine remet l'état des
+// guillemets à zéro à chaque ligne, donc un '\n' termine toujours un enregistrement :
+// la frontière est sûre et chaque morceau s'analyse comme le ferait le mode séquentiel.
+// 1) comptage des lignes par morceau (numéros de ligne exacts dans les logs),
+// 2) analyse des morceaux sur le pool de threads, dans des datasets temporaires,
+// 3) fusion dans l'ordre d'origine (lignes et diagnostics).
+void SpotifyDataset::parseRowsParallel(std::string_view text, int firstLine, const ColMap& map, unsigned nbThreads, std::ostream& log, ParseStats& stats) {
+    ThreadPool& pool = ThreadPool::global();
+    size_t nbChunks = (size_t)nbThreads * 4;
+    size_t chunkSize = text.size() / nbChunks + 1;
+
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = std::min(text.size(), begin + chunkSize);
+        if (end < text.size()) {
+            size_t nl = text.find('\n', end);
+            end = (nl == std::string_view::npos) ? text.size() : nl + 1;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    // 1) Nombre de lignes de chaque morceau -> numéro de la première ligne
+    std::vector<int> lineCounts(chunks.size(), 0);
+    pool.parallelFor(chunks.size(), [&](size_t c) {
+        lineCounts[c] = (int)std::count(chunks[c].begin(), chunks[c].end(), '\n');
+    });
+    std::vector<int> firstLines(chunks.size(), firstLine);
+    for (size_t c = 1; c < chunks.size(); ++c) firstLines[c] = firstLines[c-1] + lineCounts[c-1];
+
+    // 2) Analyse indépendante de chaque morceau
+    std::vector<SpotifyDataset> parts(chunks.size());
+    std::vector<std::ostringstream> logs(chunks.size());
+    std::vector<ParseStats> partStats(chunks.size());
+    pool.parallelFor(chunks.size(), [&](size_t c) {
+        parts[c].parseRows(chunks[c], firstLines[c], map, logs[c], partStats[c]);
+    });
+
+    // 3) Fusion dans l'ordre du fichier
+    size_t total = size();
+    for (const SpotifyDataset& part : parts) total += part.size();
+    reserve(total);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        appendRows(parts[c]);
+        log << logs[c].str();
+        stats.imported += partStats[c].imported;
+        stats.skipped += partStats[c].skipped;
+    }
+}
+
+// Le fichier est projeté en mémoire puis découpé en lignes directement dans le
+// buffer : ni std::getline, ni std::string par ligne ou par champ.
+bool SpotifyDataset::loadFromCSV(const std::string& filename, std::ostream& log, unsigned nbThreads) {
+    MappedFile file;
+    if (!file.open(filename)) return false;
+
+    clear();
+
+    std::string_view buffer = file.view();
+    ParseStats stats;
+
+    // Lire première ligne
+    if (buffer.empty()) {
+        log << "Fichier vide.\n";
+        return true; // fichier ouvert mais vide
+    }
+    ColMap map;
+    std::string_view body = parseFirstLine(buffer, map, log, stats,
+        [this](std::string_view name, const double* values) { addRow(name, values); });
+
+    // Une ligne par '\n' : colonnes et pool de noms dimensionnés une fois pour toutes
+    reserve(size() + (size_t)std::count(body.begin(), body.end(), '\n') + 1);
+
+    // Parcours des lignes restantes (parallèle seulement si le fichier le justifie)
+    if (nbThreads == 0)
+        nbThreads = (body.size() >= PARALLEL_MIN_BYTES) ? ThreadPool::global().size() : 1;
+    if (nbThreads > 1) parseRowsParallel(body, 2, map, nbThreads, log, stats);
+    else parseRows(body, 2, map, log, stats);
+    rebuildAggregates();
+
+    log << "Import CSV terminé: " << stats.imported << " ligne(s) importée(s), "
+              << stats.skipped << " ignorée(s). Total artistes: " << size() << "\n";
+    return true;
+}
+
+// Même analyse que loadFromCSV, mais chaque ligne valide est passée à onRow puis
+// oubliée. Le fichier est projeté en lecture séquentielle : les pages déjà lues
+// peuvent être rendues par le système, la mémoire utilisée ne dépend pas de la
+// taille du fichier.
+bool SpotifyDataset::streamCSV(const std::string& filename, const RowCallback& onRow, std::ostream& log) {
+    MappedFile file;
+    if (!file.open(filename)) return false;
+
+    std::string_view buffer = file.view();
+    ParseStats stats;
+    if (buffer.empty()) {
+        log << "Fichier vide.\n";
+        return true;
+    }
+    ColMap map;
+    std::string_view body = parseFirstLine(buffer, map, log, stats, onRow);
+    forEachRow(body, 2, map, log, stats, onRow);
+
+    log << "Lecture en flux terminée: " << stats.imported << " ligne(s) traitée(s), "
+        << stats.skipped << " ignorée(s).\n";
+    return true;
+}
+
+// ----------- Snapshot binaire -----------
+/*
+  Format (version 2, entiers et doubles dans l'ordre d'octets de la machine) :
+    [SnapshotHeader]
+    [5 colonnes de rowCount doubles]  streams, daily, asLead, solo, asFeature
+    [rowCount ids uint32]             id du nom de chaque ligne
+    [nameCount+1 offsets uint64]      début de chaque nom distinct dans le pool (+ fin)
+    [pool de noms]                    octets des noms distincts, dans l'ordre des ids
+  Le pool est rechargé tel quel dans le StringPool (une copie, pas de hachage).
+  Chaque bloc commence sur un multiple de 8 octets. Le checksum couvre tout ce qui
+  suit l'en-tête. Taille et date du CSV source sont mémorisées pour détecter un
+  snapshot périmé.
+*/
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'S','P','D','S','N','A','P','\0'};
+const uint32_t SNAPSHOT_VERSION = 2;
+const uint32_t SNAPSHOT_COLUMNS = 5;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nbColumns;
+    uint64_t rowCount;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t columnOffset[SNAPSHOT_COLUMNS];
+    uint64_t nameIdsOffset;
+    uint64_t nameCount;
+    uint64_t nameOffsetsOffset;
+    uint64_t poolOffset;
+    uint64_t poolSize;
+    uint64_t checksum;
+};
+
+// FNV-1a appliqué par mots de 64 bits (puis octet par octet pour la fin)
+uint64_t snapshotChecksum(const char* data, size_t n) {
+    uint64_t h = 1469598103934665603ULL;
+    const uint64_t prime = 1099511628211ULL;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h = (h ^ w) * prime;
+    }
+    for (; i < n; ++i) h = (h ^ (unsigned char)data[i]) * prime;
+    return h;
+}
+
+uint64_t align8(uint64_t x) { return (x + 7) & ~uint64_t(7); }
+
+// Taille et date de modification du CSV source; false si inaccessible
+bool sourceStamp(const std::string& file, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(file, ec);
+    if (ec) return false;
+    auto t = std::filesystem::last_write_time(file, ec);
+    if (ec) return false;
+    mtime = (int64_t)t.time_since_epoch().count();
+    return true;
+}
+
+} // namespace
+
+bool SpotifyDataset::saveSnapshot(const std::string& snapshotFile, const std::string& sourceCSV) const {
+    SnapshotHeader h{};
+    std::memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.nbColumns = SNAPSHOT_COLUMNS;
+    h.rowCount = size();
+    if (!sourceStamp(sourceCSV, h.sourceSize, h.sourceMtime)) return false;
+
+    // Construction du corps en mémoire (colonnes, offsets, pool)
+    const std::vector<double>* cols[SNAPSHOT_COLUMNS] = { &streams, &daily, &asLead, &solo, &asFeature };
+    h.nameCount = namePool.size();
+    uint64_t poolSize = 0;
+    for (uint32_t id = 0; id < h.nameCount; ++id) poolSize += namePool.view(id).size();
+
+    uint64_t off = align8(sizeof(SnapshotHeader));
+    for (uint32_t c = 0; c < SNAPSHOT_COLUMNS; ++c) {
+        h.columnOffset[c] = off;
+        off += h.rowCount * sizeof(double);
+    }
+    h.nameIdsOffset = off;
+    off = align8(off + h.rowCount * sizeof(uint32_t));
+    h.nameOffsetsOffset = off;
+    off += (h.nameCount + 1) * sizeof(uint64_t);
+    h.poolOffset = off;
+    h.poolSize = poolSize;
+    off += poolSize;
+
+    std::string body(off - sizeof(SnapshotHeader), '\0');
+    char* base = &body[0] - sizeof(SnapshotHeader); // base[offset] == octet du fichier
+    for (uint32_t c = 0; c < SNAPSHOT_COLUMNS; ++c)
+        if (h.rowCount) std::memcpy(base + h.columnOffset[c], cols[c]->data(), h.rowCount * sizeof(double));
+    if (h.rowCount) std::memcpy(base + h.nameIdsOffset, nameIds.data(), h.rowCount * sizeof(uint32_t));
+    uint64_t cursor = 0;
+    for (uint64_t id = 0; id <= h.nameCount; ++id) {
+        std::memcpy(base + h.nameOffsetsOffset + id * sizeof(uint64_t), &cursor, sizeof(uint64_t));
+        if (id < h.nameCount) {
+            std::string_view name = namePool.view((uint32_t)id);
+            std::memcpy(base + h.poolOffset + cursor, name.data(), name.size());
+            cursor += name.size();
         }
+    }
+    h.checksum = snapshotChecksum(body.data(), body.size());
+
+    // Écriture dans un fichier temporaire puis renommage (jamais de snapshot à moitié écrit)
+    std::string tmp = snapshotFile + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(body.data(), (std::streamsize)body.size());
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, snapshotFile, ec);
+    return !ec;
+}
 
-        if (!processRow(row, lineNumber, map)) skipped++; else imported++;
+bool SpotifyDataset::loadSnapshot(const std::string& snapshotFile, const std::string& sourceCSV) {
+    MappedFile file;
+    if (!file.open(snapshotFile) || file.size() < sizeof(SnapshotHeader)) return false;
+
+    SnapshotHeader h;
+    std::memcpy(&h, file.data(), sizeof(h));
+    if (std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != SNAPSHOT_VERSION || h.nbColumns != SNAPSHOT_COLUMNS) return false;
+
+    // Périmé si le CSV a changé depuis l'écriture
+    uint64_t srcSize; int64_t srcMtime;
+    if (!sourceStamp(sourceCSV, srcSize, srcMtime) ||
+        srcSize != h.sourceSize || srcMtime != h.sourceMtime) return false;
+
+    // Vérification des bornes avant tout accès
+    uint64_t n = h.rowCount;
+    uint64_t fileSize = file.size();
+    if (n > fileSize / sizeof(double)) return false;
+    for (uint32_t c = 0; c < SNAPSHOT_COLUMNS; ++c)
+        if (h.columnOffset[c] > fileSize || n * sizeof(double) > fileSize - h.columnOffset[c]) return false;
+    uint64_t nbNames = h.nameCount;
+    if (nbNames > n || h.nameIdsOffset > fileSize || n * sizeof(uint32_t) > fileSize - h.nameIdsOffset) return false;
+    if (h.nameOffsetsOffset > fileSize || (nbNames + 1) * sizeof(uint64_t) > fileSize - h.nameOffsetsOffset) return false;
+    if (h.poolOffset > fileSize || h.poolSize > fileSize - h.poolOffset) return false;
+
+    const char* base = file.data();
+    if (snapshotChecksum(base + sizeof(SnapshotHeader), file.size() - sizeof(SnapshotHeader)) != h.checksum)
+        return false;
+
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(base + h.nameOffsetsOffset);
+    if (offsets[0] != 0) return false;
+    for (uint64_t id = 0; id < nbNames; ++id)
+        if (offsets[id] > offsets[id+1] || offsets[id+1] > h.poolSize) return false;
+    const uint32_t* ids = reinterpret_cast<const uint32_t*>(base + h.nameIdsOffset);
+
+    clear();
+    std::vector<double>* cols[SNAPSHOT_COLUMNS] = { &streams, &daily, &asLead, &solo, &asFeature };
+    for (uint32_t c = 0; c < SNAPSHOT_COLUMNS; ++c) {
+        const double* p = reinterpret_cast<const double*>(base + h.columnOffset[c]);
+        cols[c]->assign(p, p + n);
     }
+    // Noms : pool recopié d'un bloc, ids repris tels quels, première ligne de chaque id
+    if (!namePool.assign(base + h.poolOffset, offsets, nbNames)) { clear(); return false; }
+    nameIds.assign(ids, ids + n);
+    rowOfName.assign(nbNames, UINT32_MAX);
+    for (uint64_t i = 0; i < n; ++i) {
+        if (ids[i] >= nbNames) { clear(); return false; }
+        if (rowOfName[ids[i]] == UINT32_MAX) rowOfName[ids[i]] = (uint32_t)i;
+    }
+    for (uint32_t row : rowOfName)
+        if (row == UINT32_MAX) { clear(); return false; } // nom sans ligne : snapshot incohérent
+    rebuildAggregates();
+    return true;
+}
 
-    std::cerr << "Import CSV terminé: " << imported << " ligne(s) importée(s), "
-              << skipped << " ignorée(s). Total artistes: " << artists.size() << "\n";
+// Démarrage : snapshot s'il est à jour, sinon import CSV puis (ré)écriture du snapshot
+bool SpotifyDataset::load(const std::string& csvFile, std::ostream& log) {
+    std::string snapshotFile = csvFile + ".snap";
+    if (loadSnapshot(snapshotFile, csvFile)) {
+        log << "Snapshot binaire chargé (" << snapshotFile << "). Total artistes: " << size() << "\n";
+        return true;
+    }
+    if (!loadFromCSV(csvFile, log)) return false;
+    if (!saveSnapshot(snapshotFile, csvFile))
+        log << "Avertissement: impossible d'écrire le snapshot " << snapshotFile << "\n";
     return true;
 }
 
+// ----------- Ajout incrémental -----------
+
+// Ajoute la ligne de 'name' ou remplace ses valeurs (anciennes valeurs dans old) ;
+// true si ajoutée. Ni agrégats ni génération : à la charge de l'appelant.
+bool SpotifyDataset::writeRow(std::string_view name, const double* values, double* old) {
+    long row = findArtist(name);
+    if (row < 0) {
+        addRow(name, values);
+        return true;
+    }
+    std::vector<double>* cols[NB_ATTRIBUTES] = { &streams, &daily, &asLead, &solo, &asFeature };
+    for (int a = 0; a < NB_ATTRIBUTES; ++a) {
+        old[a] = (*cols[a])[row];
+        (*cols[a])[row] = values[a];
+    }
+    return false;
+}
+
+// Les valeurs remplacées sont retirées des agrégats puis les nouvelles ajoutées :
+// O(1), quelle que soit la taille du dataset.
+bool SpotifyDataset::upsert(std::string_view name, const double* values) {
+    markModified();
+    double old[NB_ATTRIBUTES];
+    bool added = writeRow(name, values, old);
+    if (!added) colMoments.remove(old);
+    colMoments.add(values);
+    return added;
+}
+
+// Lecture en flux : mêmes règles de parsing que loadFromCSV, sans tout recharger.
+// Agrégats recalculés une fois en fin de lot : une suite de remove/add accumule des
+// erreurs d'arrondi (annulation quand une valeur retirée domine la moyenne).
+bool SpotifyDataset::upsertFromCSV(const std::string& filename, std::ostream& log, UpsertStats& stats) {
+    size_t rows = 0;
+    double old[NB_ATTRIBUTES];
+    bool ok = streamCSV(filename, [&](std::string_view name, const double* values) {
+        if (writeRow(name, values, old)) stats.inserted++;
+        else stats.updated++;
+        rows++;
+    }, log);
+    if (rows > 0) {
+        markModified();
+        rebuildAggregates();
+    }
+    return ok;
+}
+
+long SpotifyDataset::findArtist(std::string_view name) const {
+    uint32_t id = namePool.find(name);
+    return (id == StringPool::NOT_FOUND) ? -1 : (long)rowOfName[id];
+}
+
+void SpotifyDataset::rebuildAggregates() {
+    std::vector<const double*> cols = { streams.data(), daily.data(), asLead.data(), solo.data(), asFeature.data() };
+    colMoments = Parallel::coMoments(cols, size());
+}
+
 // ----------- Accès -----------
 
-const std::vector<Artist>& SpotifyDataset::getArtists() const {
-    return artists;
+SpotifyDataset::SpotifyDataset(const SpotifyDataset& other)
+    : namePool(other.namePool), nameIds(other.nameIds), rowOfName(other.rowOfName),
+      streams(other.streams), daily(other.daily), asLead(other.asLead),
+      solo(other.solo), asFeature(other.asFeature), generationId(other.generationId),
+      colMoments(other.colMoments) {}
+
+void SpotifyDataset::clear() {
+    markModified();
+    colMoments = CoMomentMatrix(NB_ATTRIBUTES);
+    namePool.clear();
+    nameIds.clear();
+    rowOfName.clear();
+    streams.clear();
+    daily.clear();
+    asLead.clear();
+    solo.clear();
+    asFeature.clear();
+}
+
+void SpotifyDataset::reserve(size_t n) {
+    nameIds.reserve(n);
+    namePool.reserve(n);
+    streams.reserve(n);
+    daily.reserve(n);
+    asLead.reserve(n);
+    solo.reserve(n);
+    asFeature.reserve(n);
+}
+
+void SpotifyDataset::appendRows(const SpotifyDataset& other) {
+    markModified();
+    nameIds.reserve(nameIds.size() + other.size());
+    for (uint32_t id : other.nameIds) appendName(other.namePool.view(id));
+    streams.insert(streams.end(), other.streams.begin(), other.streams.end());
+    daily.insert(daily.end(), other.daily.begin(), other.daily.end());
+    asLead.insert(asLead.end(), other.asLead.begin(), other.asLead.end());
+    solo.insert(solo.end(), other.solo.begin(), other.solo.end());
+    asFeature.insert(asFeature.end(), other.asFeature.begin(), other.asFeature.end());
+}
+
+void SpotifyDataset::addRow(std::string_view name, const double* values) {
+    appendName(name);
+    streams.push_back(values[(int)Attribute::Streams]);
+    daily.push_back(values[(int)Attribute::Daily]);
+    asLead.push_back(values[(int)Attribute::AsLead]);
+    solo.push_back(values[(int)Attribute::Solo]);
+    asFeature.push_back(values[(int)Attribute::AsFeature]);
+}
+
+size_t SpotifyDataset::size() const {
+    return nameIds.size();
+}
+
+bool SpotifyDataset::empty() const {
+    return nameIds.empty();
+}
+
+// Id du nom de la nouvelle ligne ; un nom déjà vu garde sa première ligne dans rowOfName
+void SpotifyDataset::appendName(std::string_view name) {
+    uint32_t id = namePool.intern(name);
+    if (id == rowOfName.size()) rowOfName.push_back((uint32_t)nameIds.size());
+    nameIds.push_back(id);
+}
+
+std::string_view SpotifyDataset::getName(size_t i) const {
+    return namePool.view(nameIds[i]);
+}
+
+Artist SpotifyDataset::getArtist(size_t i) const {
+    return Artist(nameIds[i], streams[i], daily[i], asLead[i], solo[i], asFeature[i]);
 }
 
-std::vector<double> SpotifyDataset::getAttribute(const std::string& attr) const {
-    std::vector<double> v;
-    for (const Artist& a : artists) {
-        if      (attr == "streams")                             v.push_back(a.getStreams());
-        else if (attr == "daily")                               v.push_back(a.getDaily());
-        else if (attr == "solo")                                v.push_back(a.getSolo());
-        else if (attr == "aslead" || attr == "as_lead")         v.push_back(a.getAsLead());
-        else if (attr == "asfeature" || attr == "as_feature")   v.push_back(a.getAsFeature());
+const std::vector<double>& SpotifyDataset::column(Attribute attr) const {
+    switch (attr) {
+        case Attribute::Streams:   return streams;
+        case Attribute::Daily:     return daily;
+        case Attribute::AsLead:    return asLead;
+        case Attribute::Solo:      return solo;
+        case Attribute::AsFeature: break;
     }
-    return v;
-}
\ No newline at end of file
+    return asFeature;
+}
+
+ColumnView SpotifyDataset::getAttribute(Attribute attr) const {
+    return ColumnView(column(attr));
+}
+
+// ----------- Index triés -----------
+
+// Compteur commun à toutes les instances : deux datasets n'ont jamais la même génération
+static std::atomic<uint64_t> nextGeneration(1);
+
+void SpotifyDataset::markModified() {
+    std::lock_guard<std::mutex> lock(indexMtx);
+    for (SortedIndex& idx : indexes) idx = SortedIndex();
+    generationId = nextGeneration.fetch_add(1);
+}
+
+const SpotifyDataset::SortedIndex& SpotifyDataset::sortedIndex(Attribute attr) const {
+    std::lock_guard<std::mutex> lock(indexMtx);
+    SortedIndex& idx = indexes[(int)attr];
+    if (!idx.built) {
+        const std::vector<double>& col = column(attr);
+        size_t n = col.size();
+        idx.order.resize(n);
+        for (size_t i = 0; i < n; ++i) idx.order[i] = (uint32_t)i;
+        // Défensif : parseNumber refuse les NaN, les colonnes n'en contiennent donc pas.
+        // Les ranger en dernier garde quand même un ordre strict faible, sans lequel
+        // std::sort (et la dichotomie qui suit) aurait un comportement indéfini
+        std::sort(idx.order.begin(), idx.order.end(), [&col](uint32_t a, uint32_t b) {
+            bool nanA = std::isnan(col[a]), nanB = std::isnan(col[b]);
+            if (nanA || nanB) return nanA != nanB ? nanB : a < b;
+            return col[a] != col[b] ? col[a] > col[b] : a < b;
+        });
+        idx.rank.resize(n);
+        for (size_t r = 0; r < n; ++r) idx.rank[idx.order[r]] = (uint32_t)r;
+        idx.built = true;
+    }
+    return idx;
+}
+
+const std::vector<uint32_t>& SpotifyDataset::sortedOrder(Attribute attr) const {
+    return sortedIndex(attr).order;
+}
+
+size_t SpotifyDataset::countGreater(Attribute attr, double seuil) const {
+    const std::vector<double>& col = column(attr);
+    const std::vector<uint32_t>& order = sortedIndex(attr).order;
+    // Ordre décroissant : les lignes > seuil forment un préfixe de l'index
+    auto it = std::partition_point(order.begin(), order.end(), [&](uint32_t r) { return col[r] > seuil; });
+    return (size_t)(it - order.begin());
+}
+
+size_t SpotifyDataset::rankOf(Attribute attr, size_t row) const {
+    if (row >= size()) return 0;
+    return sortedIndex(attr).rank[row];
+}
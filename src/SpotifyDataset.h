@@ -1,16 +1,79 @@
 #pragma once
 #include "Artist.h"
+#include "ColumnView.h"
+#include "Attribute.h"
+#include "OnlineStats.h"
+#include "StringPool.h"
 #include <vector>
 #include <string>
+#include <string_view>
+#include <iosfwd>
+#include <mutex>
+#include <functional>
+#include <cstdint>
 
+/*
+  SpotifyDataset : stockage en colonnes (struct-of-arrays).
+
+  Chaque métrique est un std::vector<double> contigu. Les noms sont internés dans un
+  StringPool (arène) : la ligne i porte l'id nameIds[i], plus aucune std::string par ligne.
+  La ligne i correspond à nameIds[i], streams[i], daily[i], ... pour toutes les colonnes.
+  getAttribute renvoie une vue sans copie sur la colonne demandée.
+
+  Index triés : pour chaque colonne, une permutation des lignes par valeur décroissante
+  (et son inverse, le rang) est construite au premier besoin puis gardée en cache.
+  Le cache est vidé à chaque rechargement.
+
+  Agrégats : moyennes et co-moments de toutes les colonnes (CoMomentMatrix, ordre
+  Attribute), calculés au chargement, tenus à jour par upsert et recalculés après
+  chaque upsertFromCSV : moyenne, variance, Pearson et droite de régression sans
+  reparcourir les données à chaque requête.
+
+  Index des noms : table de hachage du pool (nom -> id) puis rowOfName (id -> première
+  ligne portant ce nom), tenus à jour à chaque ajout de ligne.
+*/
 class SpotifyDataset {
 private:
-    std::vector<Artist> artists;
+    StringPool namePool;
+    std::vector<uint32_t> nameIds;   // ligne -> id dans namePool
+    std::vector<uint32_t> rowOfName; // id -> première ligne portant ce nom
+    std::vector<double> streams;
+    std::vector<double> daily;
+    std::vector<double> asLead;
+    std::vector<double> solo;
+    std::vector<double> asFeature;
+
+    // Index trié d'une colonne (construit paresseusement, protégé par indexMtx)
+    struct SortedIndex {
+        bool built = false;
+        std::vector<uint32_t> order; // lignes par valeur décroissante, à égalité ligne croissante
+        std::vector<uint32_t> rank;  // rank[ligne] = position dans order
+    };
+    mutable SortedIndex indexes[NB_ATTRIBUTES];
+    mutable std::mutex indexMtx;
+
+    uint64_t generationId = 0; // voir generation()
+
+    CoMomentMatrix colMoments{NB_ATTRIBUTES};
+
+    const std::vector<double>& column(Attribute attr) const;
+    const SortedIndex& sortedIndex(Attribute attr) const;
+    void rebuildAggregates();    // recalcul complet, après un chargement ou un lot d'upserts
+    // À appeler à chaque modification des lignes : index triés invalidés, nouvelle génération
+    void markModified();
+
+    void clear();
+    void reserve(size_t n);
+    void appendRows(const SpotifyDataset& other); // concatène les lignes de other
+    void addRow(std::string_view name, const double* values); // values indexé par Attribute
+    void appendName(std::string_view name); // ajoute l'id du nom de la ligne suivante
+    bool writeRow(std::string_view name, const double* values, double* old); // voir upsert
 
     // Outils de parsing
-    static std::string trim(const std::string& s);
-    static std::string normalizeKey(const std::string& s); // "As lead" -> "aslead"
-    static std::vector<std::string> parseCSVLine(const std::string& line); // RFC 4180
+    static std::string_view trim(std::string_view s);
+    static std::string normalizeKey(std::string_view s); // "As lead" -> "aslead"
+    // RFC 4180 : remplit 'fields' de vues sur 'line' (ou sur 'scratch' si déséchappement)
+    static void parseCSVLine(std::string_view line, std::vector<std::string_view>& fields, std::string& scratch);
 
     struct ColMap {
         int artist = -1;
@@ -24,17 +87,99 @@ private:
         }
     };
     // Déduit le mapping depuis la première ligne; isHeader=true si noms reconnus
-    static ColMap buildColumnMap(const std::vector<std::string>& firstRow, bool& isHeader);
+    static ColMap buildColumnMap(const std::vector<std::string_view>& firstRow, bool& isHeader);
 
     // Conversion texte -> double avec gestion milliers et virgule décimale
-    double parseNumber(const std::string& str, int linenumber) const;
+    static double parseNumber(std::string_view str, int linenumber, std::ostream& log);
+
+    // Taille de corps de fichier à partir de laquelle l'import auto passe en parallèle
+    static constexpr size_t PARALLEL_MIN_BYTES = 4 << 20;
+
+    struct ParseStats {
+        int imported = 0;
+        int skipped = 0;
+    };
+    static bool extractRow(const std::vector<std::string_view>& row, int lineno, const ColMap& map, std::ostream& log,
+                           std::string_view& name, double values[NB_ATTRIBUTES]);
+    template <class OnRow>
+    static std::string_view parseFirstLine(std::string_view buffer, ColMap& map, std::ostream& log, ParseStats& stats, OnRow&& onRow);
+    template <class OnRow>
+    static void forEachRow(std::string_view text, int firstLine, const ColMap& map, std::ostream& log, ParseStats& stats, OnRow&& onRow);
+    void parseRows(std::string_view text, int firstLine, const ColMap& map, std::ostream& log, ParseStats& stats);
+    void parseRowsParallel(std::string_view text, int firstLine, const ColMap& map, unsigned nbThreads, std::ostream& log, ParseStats& stats);
 
 public:
-    // Charge les données depuis un CSV. Renvoie true si le fichier s'ouvre (même si des lignes sont ignorées).
-    bool loadFromCSV(const std::string& filename);
+    SpotifyDataset() = default;
+    // Copie des lignes, des agrégats et de l'index des noms (base d'une nouvelle
+    // version avant upsert) ; les blocs du pool de noms sont partagés, les index
+    // triés seront reconstruits au besoin.
+    SpotifyDataset(const SpotifyDataset& other);
+    SpotifyDataset& operator=(const SpotifyDataset&) = delete;
+
+    // Charge les données depuis un CSV (projeté en mémoire, découpé sans copie).
+    // Renvoie true si le fichier s'ouvre (même si des lignes sont ignorées).
+    // Diagnostics (lignes ignorées, bilan) écrits dans 'log'.
+    // nbThreads : 1 = séquentiel, N > 1 = découpage en morceaux analysés en parallèle,
+    // 0 = automatique (parallèle sur le pool global pour les gros fichiers).
+    bool loadFromCSV(const std::string& filename, std::ostream& log, unsigned nbThreads = 0);
+
+    // Lecture en flux : chaque ligne valide est passée à onRow(nom, valeurs indexées par
+    // Attribute) sans être stockée. Mêmes règles de parsing et diagnostics que loadFromCSV.
+    // Les vues passées au callback ne sont valides que pendant l'appel.
+    using RowCallback = std::function<void(std::string_view name, const double* values)>;
+    static bool streamCSV(const std::string& filename, const RowCallback& onRow, std::ostream& log);
+
+    // Snapshot binaire en colonnes (<csv>.snap) : en-tête versionné, colonnes,
+    // pool de noms et checksum. loadSnapshot échoue (false) si le fichier est absent,
+    // corrompu ou plus ancien que le CSV source.
+    bool saveSnapshot(const std::string& snapshotFile, const std::string& sourceCSV) const;
+    bool loadSnapshot(const std::string& snapshotFile, const std::string& sourceCSV);
+
+    // Chargement de démarrage : snapshot à jour si possible, sinon CSV + écriture du snapshot
+    bool load(const std::string& csvFile, std::ostream& log);
+
+    // Ajout incrémental : chaque ligne valide de 'filename' met à jour l'artiste de
+    // même nom, ou est ajoutée s'il n'existe pas. Agrégats recalculés une fois à la fin
+    // du lot (un parcours parallèle des colonnes), génération changée une fois.
+    struct UpsertStats {
+        size_t inserted = 0;
+        size_t updated = 0;
+    };
+    bool upsertFromCSV(const std::string& filename, std::ostream& log, UpsertStats& stats);
+    // Une ligne (values indexé par Attribute) ; true si ajoutée, false si mise à jour.
+    // Agrégats mis à jour en O(1) (retrait de l'ancienne ligne, ajout de la nouvelle)
+    bool upsert(std::string_view name, const double* values);
+
+    // Identifiant de l'état des données, unique dans le processus : change à chaque
+    // chargement ou modification (clé d'invalidation des caches de résultats)
+    uint64_t generation() const { return generationId; }
+
+    // Moments et co-moments courants des colonnes (indices = Attribute)
+    const CoMomentMatrix& aggregates() const { return colMoments; }
+
+    // Ligne de l'artiste 'name' (nom exact), -1 si absent
+    long findArtist(std::string_view name) const;
+
+    // Nombre d'artistes chargés
+    size_t size() const;
+    bool empty() const;
+
+    // Accès ligne par ligne (i < size())
+    std::string_view getName(size_t i) const;
+    uint32_t getNameId(size_t i) const { return nameIds[i]; }
+    std::string_view nameOf(uint32_t nameId) const { return namePool.view(nameId); }
+    Artist getArtist(size_t i) const; // enregistrement compact (id du nom + valeurs)
+
+    // Vue sans copie sur une colonne
+    ColumnView getAttribute(Attribute attr) const;
+
+    // Lignes triées par valeur décroissante de attr.
+    // Premier appel O(n log n), ensuite O(1).
+    const std::vector<uint32_t>& sortedOrder(Attribute attr) const;
 
-    const std::vector<Artist>& getArtists() const;
+    // Nombre de lignes avec attr > seuil : recherche dichotomique dans l'index, O(log n)
+    size_t countGreater(Attribute attr, double seuil) const;
 
-    // "streams", "daily", "solo", "aslead"/"as_lead", "asfeature"/"as_feature"
-    std::vector<double> getAttribute(const std::string& attr) const;
-};
\ No newline at end of file
+    // Rang d'une ligne selon attr (0 = plus grande valeur), O(1) après construction de l'index
+    size_t rankOf(Attribute attr, size_t row) const;
+};
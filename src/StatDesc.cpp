@@ -1,124 +1,391 @@
 #include "StatDesc.h"
+#include "Parallel.h"
 #include <algorithm>
-#include <map>
+#include <cstring>
+#include <cstdint>
 #include <cmath>
 #include <iostream>
 #include <iomanip>
 
 // --- MOYENNE ---
 // Somme / n, renvoie 0.0 si data est vide.
-double StatDesc::mean(const std::vector<double>& data) {
-    double sum = 0.0;
-    for (double x : data) sum += x;
-    return data.empty() ? 0.0 : sum / data.size();
+double StatDesc::mean(ColumnView data) {
+    if (data.empty()) return 0.0;
+    return Parallel::sum(data.data(), data.size()) / data.size();
 }
 
 // --- MEDIANE ---
-// Trie une copie du vecteur puis renvoie l'élément central (ou moyenne des deux centraux)
-double StatDesc::median(std::vector<double> data) {
-    if (data.empty()) return 0.0;
-    std::sort(data.begin(), data.end());
+// Sélectionne l'élément central d'une copie des valeurs avec nth_element (O(n)).
+// Pour n pair, l'autre élément central est le maximum de la moitié basse.
+double StatDesc::median(ColumnView values) {
+    if (values.empty()) return 0.0;
+    std::vector<double> data = values.toVector();
     size_t n = data.size();
-    if (n % 2 == 0) return (data[n/2 - 1] + data[n/2]) / 2.0;
-    else return data[n/2];
+    auto mid = data.begin() + n/2;
+    std::nth_element(data.begin(), mid, data.end());
+    if (n % 2 == 0) return (*std::max_element(data.begin(), mid) + *mid) / 2.0;
+    else return *mid;
 }
 
+// --- QUANTILES ---
+// Place aux bons rangs toutes les statistiques d'ordre demandées : nth_element sur le
+// rang du milieu, puis récursion à gauche/droite avec les rangs restants.
+// 'ranks' est trié et sans doublon ; [first, last) ne contient que des rangs de [b, e).
+static void multiSelect(std::vector<double>& data, size_t b, size_t e,
+                        const std::vector<size_t>& ranks, size_t first, size_t last) {
+    if (first >= last || b >= e) return;
+    size_t mid = first + (last - first) / 2;
+    size_t r = ranks[mid];
+    std::nth_element(data.begin() + b, data.begin() + r, data.begin() + e);
+    multiSelect(data, b, r, ranks, first, mid);
+    multiSelect(data, r + 1, e, ranks, mid + 1, last);
+}
+
+std::vector<double> StatDesc::quantiles(ColumnView values, const std::vector<double>& probs) {
+    std::vector<double> res(probs.size(), 0.0);
+    if (values.empty()) return res;
+    std::vector<double> data = values.toVector();
+    size_t n = data.size();
+
+    // Rangs nécessaires : floor((n-1)p) et le suivant pour l'interpolation
+    std::vector<size_t> ranks;
+    for (double p : probs) {
+        double h = (n - 1) * std::min(1.0, std::max(0.0, p));
+        size_t lo = (size_t)h;
+        ranks.push_back(lo);
+        if (lo + 1 < n) ranks.push_back(lo + 1);
+    }
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    multiSelect(data, 0, n, ranks, 0, ranks.size());
+
+    for (size_t i = 0; i < probs.size(); ++i) {
+        double h = (n - 1) * std::min(1.0, std::max(0.0, probs[i]));
+        size_t lo = (size_t)h;
+        double frac = h - lo;
+        res[i] = (lo + 1 < n && frac > 0) ? data[lo] + frac * (data[lo + 1] - data[lo]) : data[lo];
+    }
+    return res;
+}
+
+double StatDesc::quantile(ColumnView data, double p) {
+    return quantiles(data, {p})[0];
+}
+
+// --- TABLE DE HACHAGE double -> entier ---
+// Adressage ouvert, sondage linéaire, capacité puissance de 2 (facteur de charge <= 1/2).
+// La clé est le motif binaire du double (-0.0 ramené à 0.0 pour rester cohérent avec ==).
+// Effacement par décalage arrière (pas de pierres tombales).
+namespace {
+
+class DoubleTable {
+private:
+    struct Slot {
+        uint64_t key;
+        size_t value;
+        bool used;
+    };
+    std::vector<Slot> slots;
+    size_t count;
+    size_t mask;
+
+    static uint64_t hash(uint64_t k) {
+        // Mélange de splitmix64 : les bits de poids fort des doubles sont mal répartis
+        k ^= k >> 30; k *= 0xbf58476d1ce4e5b9ULL;
+        k ^= k >> 27; k *= 0x94d049bb133111ebULL;
+        return k ^ (k >> 31);
+    }
+
+    void grow() {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.assign(old.size() * 2, Slot{0, 0, false});
+        mask = slots.size() - 1;
+        count = 0;
+        for (const Slot& sl : old)
+            if (sl.used) at(sl.key) = sl.value;
+    }
+
+public:
+    explicit DoubleTable(size_t expected = 16) : count(0) {
+        size_t cap = 16;
+        while (cap < expected * 2) cap <<= 1;
+        slots.assign(cap, Slot{0, 0, false});
+        mask = cap - 1;
+    }
+
+    static uint64_t keyOf(double x) {
+        if (x == 0.0) x = 0.0; // -0.0 -> 0.0
+        uint64_t k;
+        std::memcpy(&k, &x, sizeof(k));
+        return k;
+    }
+
+    static double valueOf(uint64_t k) {
+        double x;
+        std::memcpy(&x, &k, sizeof(x));
+        return x;
+    }
+
+    // Valeur associée à la clé (insérée à 0 si absente)
+    size_t& at(uint64_t key) {
+        if ((count + 1) * 2 > slots.size()) grow();
+        size_t i = hash(key) & mask;
+        while (slots[i].used) {
+            if (slots[i].key == key) return slots[i].value;
+            i = (i + 1) & mask;
+        }
+        slots[i] = Slot{key, 0, true};
+        count++;
+        return slots[i].value;
+    }
+
+    // Pointeur vers la valeur, nullptr si absente
+    size_t* find(uint64_t key) {
+        size_t i = hash(key) & mask;
+        while (slots[i].used) {
+            if (slots[i].key == key) return &slots[i].value;
+            i = (i + 1) & mask;
+        }
+        return nullptr;
+    }
+
+    void erase(uint64_t key) {
+        size_t i = hash(key) & mask;
+        while (slots[i].used && slots[i].key != key) i = (i + 1) & mask;
+        if (!slots[i].used) return;
+        // Décalage arrière : on remonte les éléments suivants qui peuvent occuper le trou
+        size_t hole = i;
+        size_t j = (i + 1) & mask;
+        while (slots[j].used) {
+            size_t home = hash(slots[j].key) & mask;
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                slots[hole] = slots[j];
+                hole = j;
+            }
+            j = (j + 1) & mask;
+        }
+        slots[hole].used = false;
+        count--;
+    }
+
+    template <class F>
+    void forEach(F f) const {
+        for (const Slot& sl : slots)
+            if (sl.used) f(sl.key, sl.value);
+    }
+};
+
+} // namespace
+
 // --- MODE ---
-// Compte les fréquences avec std::map, puis récupère la ou les valeurs de fréquence max
-std::vector<double> StatDesc::mode(const std::vector<double>& data) {
-    std::map<double, int> freq;
-    for (double x : data) freq[x]++;
-    int maxFreq = 0;
-    for (const auto& p : freq)
-        if (p.second > maxFreq) maxFreq = p.second;
+// Compte les fréquences dans une table de hachage plate (pas d'allocation par valeur),
+// puis récupère la ou les valeurs de fréquence max
+std::vector<double> StatDesc::mode(ColumnView data) {
+    DoubleTable freq(std::min<size_t>(data.size(), 1 << 16));
+    for (double x : data) freq.at(DoubleTable::keyOf(x))++;
+    size_t maxFreq = 0;
+    freq.forEach([&](uint64_t, size_t c) { if (c > maxFreq) maxFreq = c; });
 
     std::vector<double> modes;
-    for (const auto& p : freq)
-        if (p.second == maxFreq) modes.push_back(p.first);
-
+    freq.forEach([&](uint64_t k, size_t c) { if (c == maxFreq) modes.push_back(DoubleTable::valueOf(k)); });
+    std::sort(modes.begin(), modes.end());
     return modes;
 }
 
+// --- HEAVY HITTERS (Space-Saving) ---
+// k compteurs rangés en tas-min sur count ; la table donne la position de chaque valeur
+// dans le tas. Valeur suivie -> count+1. Sinon, si le tas est plein, la valeur remplace
+// le plus petit compteur (count = min+1, error = min). Coût O(log k) par élément.
+std::vector<StatDesc::HeavyHitter> StatDesc::heavyHitters(ColumnView data, size_t k) {
+    std::vector<HeavyHitter> res;
+    if (k == 0 || data.empty()) return res;
+
+    struct Counter { uint64_t key; size_t count; size_t error; };
+    std::vector<Counter> heap;
+    heap.reserve(k);
+    DoubleTable pos(k);
+
+    auto swapAt = [&](size_t a, size_t b) {
+        std::swap(heap[a], heap[b]);
+        *pos.find(heap[a].key) = a;
+        *pos.find(heap[b].key) = b;
+    };
+    auto siftDown = [&](size_t i) {
+        while (true) {
+            size_t l = 2*i + 1, r = l + 1, m = i;
+            if (l < heap.size() && heap[l].count < heap[m].count) m = l;
+            if (r < heap.size() && heap[r].count < heap[m].count) m = r;
+            if (m == i) return;
+            swapAt(i, m);
+            i = m;
+        }
+    };
+    auto siftUp = [&](size_t i) {
+        while (i > 0 && heap[(i-1)/2].count > heap[i].count) {
+            swapAt(i, (i-1)/2);
+            i = (i-1)/2;
+        }
+    };
+
+    for (double x : data) {
+        uint64_t key = DoubleTable::keyOf(x);
+        if (size_t* p = pos.find(key)) {
+            heap[*p].count++;
+            siftDown(*p);
+        } else if (heap.size() < k) {
+            heap.push_back(Counter{key, 1, 0});
+            pos.at(key) = heap.size() - 1;
+            siftUp(heap.size() - 1);
+        } else {
+            size_t minCount = heap[0].count;
+            pos.erase(heap[0].key);
+            heap[0] = Counter{key, minCount + 1, minCount};
+            pos.at(key) = 0;
+            siftDown(0);
+        }
+    }
+
+    for (const Counter& c : heap) res.push_back(HeavyHitter{DoubleTable::valueOf(c.key), c.count, c.error});
+    std::sort(res.begin(), res.end(), [](const HeavyHitter& a, const HeavyHitter& b) {
+        return a.count != b.count ? a.count > b.count : a.value < b.value;
+    });
+    return res;
+}
+
 // --- MIN ---
-double StatDesc::min(const std::vector<double>& data) {
-    if (data.empty()) return 0.0;
-    return *std::min_element(data.begin(), data.end());
+double StatDesc::min(ColumnView data) {
+    double mn = 0.0, mx = 0.0;
+    Parallel::minMax(data.data(), data.size(), mn, mx);
+    return mn;
 }
 
 // --- MAX ---
-double StatDesc::max(const std::vector<double>& data) {
-    if (data.empty()) return 0.0;
-    return *std::max_element(data.begin(), data.end());
+double StatDesc::max(ColumnView data) {
+    double mn = 0.0, mx = 0.0;
+    Parallel::minMax(data.data(), data.size(), mn, mx);
+    return mx;
 }
 
 // --- AMPLITUDE ---
-double StatDesc::amplitude(const std::vector<double>& data) {
-    if (data.empty()) return 0.0;
-    auto mm = std::minmax_element(data.begin(), data.end());
-    return *mm.second - *mm.first;
+double StatDesc::amplitude(ColumnView data) {
+    double mn = 0.0, mx = 0.0;
+    Parallel::minMax(data.data(), data.size(), mn, mx);
+    return mx - mn;
 }
 
 // --- VARIANCE ---
 // Somme des (x-m)^2, divisée par (n-1) si sample=true, sinon par n.
 // Si data.size()<2 -> 0.0
-double StatDesc::variance(const std::vector<double>& data, bool sample) {
+double StatDesc::variance(ColumnView data, bool sample) {
     if (data.size() < 2) return 0.0;
     double m = mean(data);
-    double var = 0.0;
-    for (double x : data) var += (x-m)*(x-m);
+    double var = Parallel::sumSqDev(data.data(), data.size(), m);
     return var / (data.size() - (sample ? 1 : 0));
 }
 
 // --- ECART-TYPE ---
 // Racine carrée de la variance
-double StatDesc::stddev(const std::vector<double>& data, bool sample) {
+double StatDesc::stddev(ColumnView data, bool sample) {
     return std::sqrt(variance(data, sample));
 }
 
+// --- RESUME EN UN PASSAGE ---
+// Moments centrés mis à jour de façon incrémentale (voir Moments dans OnlineStats) :
+// pas de seconde passe pour la variance, stable même pour de grandes valeurs.
+// Un accumulateur par morceau de lignes, fusionnés dans l'ordre (Parallel::moments).
+StatDesc::Summary StatDesc::summary(ColumnView data) {
+    return fromMoments(Parallel::moments(data.data(), data.size()));
+}
+
+StatDesc::Summary StatDesc::fromMoments(const Moments& m) {
+    Summary s;
+    s.count = m.count();
+    if (s.count == 0) return s;
+    s.sum = m.sum();
+    s.mean = m.mean();
+    s.m2 = m.sumSqDev();
+    s.min = m.min();
+    s.max = m.max();
+    s.skewness = m.skewness();
+    s.kurtosis = m.kurtosis();
+    return s;
+}
+
+double StatDesc::Summary::variance(bool sample) const {
+    if (count < 2) return 0.0;
+    return m2 / (count - (sample ? 1 : 0));
+}
+
+double StatDesc::Summary::stddev(bool sample) const {
+    return std::sqrt(variance(sample));
+}
+
+// --- TOP K (tas borné) ---
+// valueAt(i) donne la valeur de la ligne i. Le résultat sert lui-même de tas :
+// avec le comparateur "meilleur que", la tête du tas est la pire ligne retenue,
+// remplacée dès qu'une ligne meilleure arrive. sort_heap rend ensuite l'ordre final.
+template <class ValueAt>
+static std::vector<size_t> boundedTopK(size_t rows, int n, ValueAt valueAt) {
+    std::vector<size_t> heap;
+    if (n <= 0 || rows == 0) return heap;
+    size_t k = std::min((size_t)n, rows);
+    heap.reserve(k);
+
+    auto better = [&valueAt](size_t a, size_t b) {
+        double va = valueAt(a), vb = valueAt(b);
+        return va != vb ? va > vb : a < b;
+    };
+
+    for (size_t i = 0; i < rows; ++i) {
+        if (heap.size() < k) {
+            heap.push_back(i);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(i, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = i;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), better);
+    return heap;
+}
+
 // --- TOP N ---
-// Copie le vecteur d'artistes, trie selon l'attribut demandé (ordre décroissant), puis prend les N premiers.
-// Si attr est inconnu, av et bv restent à 0 -> l'ordre résultant sera arbitraire.
-std::vector<Artist> StatDesc::topN(const std::vector<Artist>& artists, int n, const std::string& attr) {
-    std::vector<Artist> sorted = artists;
-    std::sort(sorted.begin(), sorted.end(), [attr](const Artist& a, const Artist& b) {
-        double av = 0, bv = 0;
-        if      (attr == "streams")    { av=a.getStreams();    bv=b.getStreams();}
-        else if (attr == "daily")      { av=a.getDaily();      bv=b.getDaily();}
-        else if (attr == "solo")       { av=a.getSolo();       bv=b.getSolo();}
-        else if (attr == "aslead" || attr == "as_lead")   { av=a.getAsLead();     bv=b.getAsLead();}
-        else if (attr == "asfeature" || attr == "as_feature") { av=a.getAsFeature(); bv=b.getAsFeature();}
-        return av > bv; // Trie du plus grand au plus petit
-    });
-    if (n > (int)sorted.size()) n = sorted.size();
-    return std::vector<Artist>(sorted.begin(), sorted.begin() + n);
+std::vector<size_t> StatDesc::topN(ColumnView values, int n) {
+    return boundedTopK(values.size(), n, [&values](size_t i) { return values[i]; });
+}
+
+// Préfixe de l'index trié du dataset
+std::vector<size_t> StatDesc::topN(const SpotifyDataset& dataset, int n, Attribute attr) {
+    const std::vector<uint32_t>& order = dataset.sortedOrder(attr);
+    size_t k = n <= 0 ? 0 : std::min((size_t)n, order.size());
+    return std::vector<size_t>(order.begin(), order.begin() + k);
 }
 
 // --- TOP GAP LEAD/FEATURE ---
-// Classe les artistes selon l'écart absolu entre asLead et asFeature
-std::vector<Artist> StatDesc::topGapLeadFeature(const std::vector<Artist>& artists, int n) {
-    std::vector<std::pair<double, const Artist*>> byGap;
-    for(const Artist& a : artists)
-        byGap.push_back({std::abs(a.getAsLead()-a.getAsFeature()), &a});
-    std::sort(byGap.begin(), byGap.end(), [](const auto& x, const auto& y){
-        return x.first > y.first;
-    });
-    std::vector<Artist> res;
-    for(int i=0; i<n && i<(int)byGap.size(); ++i) res.push_back(*byGap[i].second);
-    return res;
+// Classe les artistes selon l'écart absolu entre asLead et asFeature (calculé à la volée)
+std::vector<size_t> StatDesc::topGapLeadFeature(const SpotifyDataset& dataset, int n) {
+    ColumnView lead = dataset.getAttribute(Attribute::AsLead);
+    ColumnView feat = dataset.getAttribute(Attribute::AsFeature);
+    return boundedTopK(lead.size(), n, [&](size_t i) { return std::abs(lead[i] - feat[i]); });
 }
 
 // --- AFFICHAGE : ratio solo/feature par artiste ---
 // Pour chaque artiste : affiche %solo et %feature, basés sur le total de streams de l'artiste.
-void StatDesc::printSoloFeatureRatio(const std::vector<Artist>& artists) {
-    std::cout << std::fixed << std::setprecision(2);
-    std::cout << "Artiste                  %solo   %feature\n";
-    std::cout << "------------------------------------------------\n";
-    for (const Artist& a : artists) {
-        double total = a.getStreams();
+void StatDesc::printSoloFeatureRatio(const SpotifyDataset& dataset, std::ostream& out) {
+    ColumnView streams = dataset.getAttribute(Attribute::Streams);
+    ColumnView solo = dataset.getAttribute(Attribute::Solo);
+    ColumnView feat = dataset.getAttribute(Attribute::AsFeature);
+    out << std::fixed << std::setprecision(2);
+    out << "Artiste                  %solo   %feature\n";
+    out << "------------------------------------------------\n";
+    for (size_t i = 0; i < dataset.size(); ++i) {
+        double total = streams[i];
         if (total == 0.0) continue; // éviter division par 0
-        double psolo = 100.0 * a.getSolo() / total;
-        double pfeat = 100.0 * a.getAsFeature() / total;
-        std::cout << std::setw(22) << std::left << a.getName()
+        double psolo = 100.0 * solo[i] / total;
+        double pfeat = 100.0 * feat[i] / total;
+        out << std::setw(22) << std::left << dataset.getName(i)
                   << std::setw(8) << psolo 
                   << std::setw(8) << pfeat << '\n';
     }
@@ -126,21 +393,21 @@ void StatDesc::printSoloFeatureRatio(const std::vector<Artist>& artists) {
 
 // --- AFFICHAGE : répartition globale ---
 // Calcule les % sur la somme globale des streams (solo, feature, autre = reste)
-void StatDesc::printGlobalSoloFeatureRatio(const std::vector<Artist>& artists) {
-    double total = 0.0, solo = 0.0, feature = 0.0;
-    for(const Artist& a : artists) {
-        total += a.getStreams();
-        solo += a.getSolo();
-        feature += a.getAsFeature();
-    }
+void StatDesc::printGlobalSoloFeatureRatio(const SpotifyDataset& dataset, std::ostream& out) {
+    ColumnView streamsCol = dataset.getAttribute(Attribute::Streams);
+    ColumnView soloCol = dataset.getAttribute(Attribute::Solo);
+    ColumnView featCol = dataset.getAttribute(Attribute::AsFeature);
+    double total = Parallel::sum(streamsCol.data(), streamsCol.size());
+    double solo = Parallel::sum(soloCol.data(), soloCol.size());
+    double feature = Parallel::sum(featCol.data(), featCol.size());
     if (total == 0.0) {
-        std::cout << "Aucune donnée.\n"; return;
+        out << "Aucune donnée.\n"; return;
     }
     double psolo = 100.0 * solo / total;
     double pfeat = 100.0 * feature / total;
-    std::cout << std::fixed << std::setprecision(2);
-    std::cout << "Répartition globale des streams:\n";
-    std::cout << "% solo: " << psolo << "\n";
-    std::cout << "% feature: " << pfeat << "\n";
-    std::cout << "Autre: " << (100.0 - psolo - pfeat) << "\n";
+    out << std::fixed << std::setprecision(2);
+    out << "Répartition globale des streams:\n";
+    out << "% solo: " << psolo << "\n";
+    out << "% feature: " << pfeat << "\n";
+    out << "Autre: " << (100.0 - psolo - pfeat) << "\n";
 }
@@ -1,46 +1,96 @@
 #pragma once
 #include "Artist.h"
+#include "SpotifyDataset.h"
+#include "ColumnView.h"
+#include "OnlineStats.h"
 #include <vector>
 #include <string>
+#include <iostream>
 
 /*
-  StatDesc : statistiques descriptives et classements sur des vecteurs numériques
-  et sur le vecteur d'artistes.
+  StatDesc : statistiques descriptives et classements sur des colonnes numériques
+  (ColumnView, construit implicitement depuis un std::vector<double>) et sur le dataset.
 */
 class StatDesc {
 public:
+    // Résumé calculé en un seul passage (voir summary)
+    struct Summary {
+        size_t count = 0;
+        double sum = 0.0;
+        double mean = 0.0;
+        double m2 = 0.0;        // somme des (x-mean)^2
+        double min = 0.0;
+        double max = 0.0;
+        double skewness = 0.0;  // asymétrie g1 = sqrt(n)*M3 / M2^1.5
+        double kurtosis = 0.0;  // kurtosis en excès g2 = n*M4 / M2^2 - 3
+
+        double variance(bool sample=true) const;
+        double stddev(bool sample=true) const;
+        double amplitude() const { return max - min; }
+    };
+
+    // Count, somme, moyenne, M2, min, max, asymétrie et kurtosis en un seul parcours
+    // (mise à jour de Welford étendue aux moments d'ordre 3 et 4).
+    static Summary summary(ColumnView data);
+    // Même résumé à partir d'un accumulateur déjà rempli (lecture en flux, morceaux fusionnés)
+    static Summary fromMoments(const Moments& m);
+
     // Moyenne arithmétique
-    static double mean(const std::vector<double>& data);
+    static double mean(ColumnView data);
+
+    // Médiane (copie + sélection nth_element en O(n), pas de tri complet)
+    static double median(ColumnView data);
 
-    // Médiane (copie et tri du vecteur)
-    static double median(std::vector<double> data);
+    // Quantiles aux probabilités probs (dans [0,1]), interpolation linéaire entre
+    // les deux statistiques d'ordre encadrant (n-1)*p (définition "type 7" de R/numpy).
+    // Une seule copie des données et une multi-sélection en O(n log k) pour k quantiles.
+    static std::vector<double> quantiles(ColumnView data, const std::vector<double>& probs);
+    static double quantile(ColumnView data, double p);
 
-    // Mode(s) : renvoie tous les modes (valeurs les plus fréquentes)
-    static std::vector<double> mode(const std::vector<double>& data);
+    // Mode(s) : renvoie tous les modes (valeurs les plus fréquentes), triés par ordre croissant.
+    // Comptage exact dans une table de hachage à adressage ouvert (clé = bits du double).
+    static std::vector<double> mode(ColumnView data);
+
+    // Valeur fréquente estimée par l'algorithme Space-Saving
+    struct HeavyHitter {
+        double value;
+        size_t count;   // fréquence estimée (jamais sous-estimée)
+        size_t error;   // surestimation maximale : vraie fréquence >= count - error
+    };
+
+    // Heavy hitters approximatifs en mémoire O(k) (colonnes continues où presque
+    // toutes les valeurs sont distinctes). Toute valeur de fréquence > n/k est
+    // garantie présente. Trié par count décroissant ; le premier est le mode approché.
+    static std::vector<HeavyHitter> heavyHitters(ColumnView data, size_t k);
 
     // Minimum/Maximum (0.0 si data vide)
-    static double min(const std::vector<double>& data);
-    static double max(const std::vector<double>& data);
+    static double min(ColumnView data);
+    static double max(ColumnView data);
 
     //Amplitude
-    static double amplitude(const std::vector<double>& data);
+    static double amplitude(ColumnView data);
 
     // Variance : si sample=true, divise par (n-1), sinon par n
-    static double variance(const std::vector<double>& data, bool sample=true);
+    static double variance(ColumnView data, bool sample=true);
 
     // Ecart-type : racine de la variance
-    static double stddev(const std::vector<double>& data, bool sample=true);
+    static double stddev(ColumnView data, bool sample=true);
+
+    // Indices (lignes du dataset) des N plus grandes valeurs, ordre décroissant ;
+    // à égalité, la ligne la plus petite d'abord. Tas borné à N éléments :
+    // O(n log N), aucune allocation hors du résultat.
+    static std::vector<size_t> topN(ColumnView values, int n);
 
-    // Retourne les N premiers artistes selon un attribut (ordre décroissant)
-    // attr: "streams", "daily", "solo", "aslead"/"as_lead", "asfeature"/"as_feature"
-    static std::vector<Artist> topN(const std::vector<Artist>& artists, int n, const std::string& attr);
+    // Idem sur une colonne du dataset, en lisant son index trié (même ordre, O(N) une
+    // fois l'index construit)
+    static std::vector<size_t> topN(const SpotifyDataset& dataset, int n, Attribute attr);
 
-    // Classement par plus grand écart absolu entre asLead et asFeature
-    static std::vector<Artist> topGapLeadFeature(const std::vector<Artist>& artists, int n);
+    // Classement par plus grand écart absolu entre asLead et asFeature (indices de lignes)
+    static std::vector<size_t> topGapLeadFeature(const SpotifyDataset& dataset, int n);
 
     // Affichage du % de solo et % de feature par artiste (sur le total de l'artiste)
-    static void printSoloFeatureRatio(const std::vector<Artist>& artists);
+    static void printSoloFeatureRatio(const SpotifyDataset& dataset, std::ostream& out = std::cout);
 
     // Affichage de la répartition globale (sur la somme de tous les streams du dataset)
-    static void printGlobalSoloFeatureRatio(const std::vector<Artist>& artists);
+    static void printGlobalSoloFeatureRatio(const SpotifyDataset& dataset, std::ostream& out = std::cout);
 };
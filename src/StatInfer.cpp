@@ -1,4 +1,5 @@
 #include "StatInfer.h"
+#include "Parallel.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -7,67 +8,53 @@
 // Renvoie n / total, indépendamment de l'attribut.
 // Cela représente une proba uniforme si on suppose qu'un artiste choisi au hasard a
 // une chance n/total d'être dans le top N.
-double StatInfer::probaTopN(const std::vector<Artist>& artists, int n, const std::string& attr) {
-    n = std::min(n, (int)artists.size());
-    return n / (double)artists.size();
+double StatInfer::probaTopN(const SpotifyDataset& dataset, int n, Attribute attr) {
+    n = std::min(n, (int)dataset.size());
+    return n / (double)dataset.size();
 }
 
 // --- Proba qu’un artiste ait un ratio solo > seuil ---
-// On parcourt les artistes et on compte ceux dont (solo/streams) > seuilRatio.
-double StatInfer::probaParSoloRatio(const std::vector<Artist>& artists, double seuilRatio) {
-    int count = 0;
-    for(const Artist& a: artists) {
-        double soloRatio = (a.getStreams() == 0) ? 0 : (a.getSolo() / a.getStreams());
-        if(soloRatio > seuilRatio) count++;
-    }
-    return artists.empty() ? 0.0 : (count / (double)artists.size());
+// On compte (par morceaux, en parallèle) les artistes dont (solo/streams) > seuilRatio.
+double StatInfer::probaParSoloRatio(const SpotifyDataset& dataset, double seuilRatio) {
+    ColumnView streams = dataset.getAttribute(Attribute::Streams);
+    ColumnView solo = dataset.getAttribute(Attribute::Solo);
+    size_t count = Parallel::count(streams.size(), [&](size_t i) {
+        double soloRatio = (streams[i] == 0) ? 0 : (solo[i] / streams[i]);
+        return soloRatio > seuilRatio;
+    });
+    return dataset.empty() ? 0.0 : (count / (double)dataset.size());
 }
 
 // --- Proba conditionnelle : être top N en daily parmi les artistes dont streams > seuilStreams ---
-// On filtre les artistes (streams > seuil), on trie ce sous-ensemble par daily,
-// puis on renvoie n / (taille du sous-ensemble).
-double StatInfer::probaCondTopNdaily_given_highStreams(const std::vector<Artist>& artists, double seuilStreams, int n) {
-if (artists.empty()) return 0.0;
-// 1) Pointeurs vers tous les artistes pour trier par daily (global)
-std::vector<const Artist*> all;
-all.reserve(artists.size());
-for (const Artist& a : artists) all.push_back(&a);
-
-std::sort(all.begin(), all.end(),
-          [](const Artist* a, const Artist* b){ return a->getDaily() > b->getDaily(); });
-
-if (n > (int)all.size()) n = (int)all.size();
-
-// 2) Ensemble du top-N global par daily
-std::unordered_set<const Artist*> topDaily;
-for (int i = 0; i < n; ++i) topDaily.insert(all[i]);
+// Le top-N daily vient de l'index trié (préfixe), le nombre d'artistes avec
+// streams > seuil d'une recherche dichotomique : plus de tri à chaque appel.
+double StatInfer::probaCondTopNdaily_given_highStreams(const SpotifyDataset& dataset, double seuilStreams, int n) {
+    if (dataset.empty()) return 0.0;
+    ColumnView streams = dataset.getAttribute(Attribute::Streams);
 
-// 3) Filtrer par streams > seuil
-std::vector<const Artist*> filtered;
-for (const Artist& a : artists)
-    if (a.getStreams() > seuilStreams) filtered.push_back(&a);
+    // 1) Nombre d'artistes filtrés (streams > seuil)
+    size_t filtered = dataset.countGreater(Attribute::Streams, seuilStreams);
+    if (filtered == 0) return 0.0;
 
-if (filtered.empty()) return 0.0;
+    // 2) Parmi le top-N global par daily, ceux qui passent le filtre
+    const std::vector<uint32_t>& byDaily = dataset.sortedOrder(Attribute::Daily);
+    if (n > (int)byDaily.size()) n = (int)byDaily.size();
+    int countInTop = 0;
+    for (int i = 0; i < n; ++i)
+        if (streams[byDaily[i]] > seuilStreams) countInTop++;
 
-// 4) Proportion des filtrés qui appartiennent au top-N global daily
-int countInTop = 0;
-for (const Artist* p : filtered)
-    if (topDaily.count(p)) countInTop++;
-
-return countInTop / (double)filtered.size();
+    return countInTop / (double)filtered;
 }
 
-// --- IC sur la moyenne (approx. gaussienne, 95% -> z=1.96) ---
+// --- IC sur la moyenne (approx. gaussienne, z = quantile 1-alpha/2) ---
 // Renvoie la demi-largeur de l'IC : mean ± demiLargeur
-double StatInfer::intervalleConfianceMoyenne(const std::vector<double>& data, double alpha) {
-    double m = 0.0, sq = 0.0;
+double StatInfer::intervalleConfianceMoyenne(ColumnView data, double alpha) {
     int n = data.size();
     if(n < 2) return 0.0;
-    for(double x : data) m += x; 
-    m = m / n;
-    for(double x : data) sq += (x-m)*(x-m);
+    double m = Parallel::sum(data.data(), n) / n;
+    double sq = Parallel::sumSqDev(data.data(), n, m);
     double s = std::sqrt(sq/(n-1));
-    double z = 1.96; // alpha=0.05 (approx). Pour petits n, une loi t serait plus adaptée.
+    double z = normalQuantile(1.0 - alpha / 2.0); // 1.96 pour alpha=0.05. Pour petits n, une loi t serait plus adaptée.
     return z * s / std::sqrt(n); // Demi-largeur
 }
 
@@ -76,24 +63,116 @@ double StatInfer::intervalleConfianceMoyenne(const std::vector<double>& data, do
 double StatInfer::intervalleConfianceProportion(int nbSuccess, int nbTotal, double alpha) {
     if(nbTotal == 0) return 0.0;
     double p = nbSuccess/(double)nbTotal;
-    double z = 1.96; // alpha=0.05
+    double z = normalQuantile(1.0 - alpha / 2.0);
     return z * std::sqrt(p * (1 - p) / nbTotal);
 }
 
+// --- Fonction bêta incomplète régularisée I_x(a,b) ---
+// Fraction continue évaluée par la méthode de Lentz (converge vite pour x < (a+1)/(a+b+2),
+// sinon on utilise la symétrie I_x(a,b) = 1 - I_{1-x}(b,a)).
+static double betaContinuedFraction(double a, double b, double x) {
+    const double tiny = 1e-300, eps = 1e-15;
+    double qab = a + b, qap = a + 1, qam = a - 1;
+    double c = 1.0, d = 1.0 - qab * x / qap;
+    if (std::fabs(d) < tiny) d = tiny;
+    d = 1.0 / d;
+    double h = d;
+    for (int m = 1; m <= 300; ++m) {
+        int m2 = 2 * m;
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1.0 + aa * d; if (std::fabs(d) < tiny) d = tiny;
+        c = 1.0 + aa / c; if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        h *= d * c;
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1.0 + aa * d; if (std::fabs(d) < tiny) d = tiny;
+        c = 1.0 + aa / c; if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double del = d * c;
+        h *= del;
+        if (std::fabs(del - 1.0) < eps) break;
+    }
+    return h;
+}
+
+static double incompleteBeta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    double lbt = std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1.0 - x);
+    double bt = std::exp(lbt);
+    if (x < (a + 1.0) / (a + b + 2.0)) return bt * betaContinuedFraction(a, b, x) / a;
+    return 1.0 - bt * betaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+// --- Lois normale et de Student ---
+double StatInfer::normalCdf(double z) {
+    return 0.5 * std::erfc(-z / std::sqrt(2.0));
+}
+
+double StatInfer::pValueNormal(double z) {
+    return std::erfc(std::fabs(z) / std::sqrt(2.0));
+}
+
+// P(|T| >= |t|) = I_{df/(df+t²)}(df/2, 1/2)
+double StatInfer::pValueStudent(double t, double df) {
+    if (df <= 0) return 1.0;
+    return incompleteBeta(df / 2.0, 0.5, df / (df + t * t));
+}
+
+double StatInfer::studentCdf(double t, double df) {
+    double tail = pValueStudent(t, df) / 2.0;
+    return (t > 0) ? 1.0 - tail : tail;
+}
+
+// --- Quantile de la loi normale ---
+// Approximation rationnelle d'Acklam (région centrale + deux queues).
+double StatInfer::normalQuantile(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    if (p <= 0.0) return -HUGE_VAL;
+    if (p >= 1.0) return HUGE_VAL;
+    const double plow = 0.02425;
+    if (p < plow) {
+        double q = std::sqrt(-2 * std::log(p));
+        return (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+               ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1);
+    }
+    if (p > 1 - plow) return -normalQuantile(1 - p);
+    double q = p - 0.5, r = q * q;
+    return (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5]) * q /
+           (((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1);
+}
+
 // --- t-test (deux moyennes, écart-type empirique) ---
 // Calcul du t de Welch (sans p-value).
-double StatInfer::ttest2moyennes(const std::vector<double>& X, const std::vector<double>& Y) {
+double StatInfer::ttest2moyennes(ColumnView X, ColumnView Y) {
+    return welchTest(X, Y).t; // p-value : voir welchTest
+}
+
+// --- Test t de Welch avec p-value ---
+// df = (s1²/n1 + s2²/n2)² / ((s1²/n1)²/(n1-1) + (s2²/n2)²/(n2-1))
+StatInfer::WelchTest StatInfer::welchTest(ColumnView X, ColumnView Y) {
+    WelchTest res;
     int n1 = X.size(), n2 = Y.size();
-    if(n1 < 2 || n2 < 2) return 0.0;
-    double m1=0, m2=0, s1=0, s2=0;
-    for(double x : X) m1 += x; m1 /= n1;
-    for(double y : Y) m2 += y; m2 /= n2;
-    for(double x:X) s1+=(x-m1)*(x-m1);
-    for(double y:Y) s2+=(y-m2)*(y-m2);
+    if(n1 < 2 || n2 < 2) { res.pValue = 1.0; return res; }
+    double m1 = Parallel::sum(X.data(), n1) / n1;
+    double m2 = Parallel::sum(Y.data(), n2) / n2;
+    double s1 = Parallel::sumSqDev(X.data(), n1, m1);
+    double s2 = Parallel::sumSqDev(Y.data(), n2, m2);
     s1 = std::sqrt(s1/(n1-1));
     s2 = std::sqrt(s2/(n2-1));
-    double t = (m1-m2)/std::sqrt((s1*s1)/n1 + (s2*s2)/n2);
-    return t; // La p-value n'est pas calculée ici
+    double v1 = (s1*s1)/n1, v2 = (s2*s2)/n2;
+    if (v1 + v2 == 0) return res;
+    res.t = (m1-m2)/std::sqrt(v1 + v2);
+    res.df = (v1 + v2) * (v1 + v2) / (v1*v1/(n1-1) + v2*v2/(n2-1));
+    res.pValue = pValueStudent(res.t, res.df);
+    return res;
 }
 
 // --- z-test de proportion ---
@@ -107,43 +186,179 @@ double StatInfer::testProportion(int nbSucc, int nbTotal, double p0) {
 
 // --- Régression linéaire simple Y = aX + b, ainsi que R² ---
 // a : pente, b : ordonnée à l'origine, r2 : coefficient de détermination.
-void StatInfer::regressionLineaire(const std::vector<double>& X, const std::vector<double>& Y, double& a, double& b, double& r2) {
-    double mx=0, my=0, sxy=0, sxx=0, syy=0;
-    int n = X.size(); if(n==0 || n!=Y.size()) {a=0; b=0; r2=0; return;}
-    for(int i=0;i<n;++i){mx+=X[i]; my+=Y[i];}
-    mx/=n; my/=n;
-    for(int i=0;i<n;++i){
-        sxy += (X[i]-mx)*(Y[i]-my);
-        sxx += (X[i]-mx)*(X[i]-mx);
-        syy += (Y[i]-my)*(Y[i]-my);
-    }
+void StatInfer::regressionLineaire(ColumnView X, ColumnView Y, double& a, double& b, double& r2) {
+    size_t n = X.size(); if(n==0 || n!=Y.size()) {a=0; b=0; r2=0; return;}
+    double mx = Parallel::sum(X.data(), n) / n;
+    double my = Parallel::sum(Y.data(), n) / n;
+    Kernels::CrossDev d = Parallel::crossDev(X.data(), Y.data(), n, mx, my);
+    double sxx = d.sxx, syy = d.syy, sxy = d.sxy;
     a = (sxx==0) ? 0.0 : sxy/sxx;
     b = my - a*mx;
     double r = (sxx==0||syy==0)?0 : sxy/std::sqrt(sxx*syy);
     r2 = r*r;
 }
 
+void StatInfer::regressionLineaire(const CoMomentMatrix& m, size_t ix, size_t iy, double& a, double& b, double& r2) {
+    if (m.count() == 0) { a = 0; b = 0; r2 = 0; return; }
+    double sxx = m.coDev(ix, ix), sxy = m.coDev(ix, iy);
+    a = (sxx == 0) ? 0.0 : sxy / sxx;
+    b = m.mean(iy) - a * m.mean(ix);
+    double r = m.pearson(ix, iy);
+    r2 = r * r;
+}
+
+// --- Factorisation de Cholesky A = L L' (A symétrique p x p, row-major) ---
+// Renvoie false si A n'est pas définie positive (prédicteurs colinéaires).
+static bool cholesky(std::vector<double>& a, size_t p) {
+    for (size_t j = 0; j < p; ++j) {
+        double d = a[j*p + j];
+        for (size_t k = 0; k < j; ++k) d -= a[j*p + k] * a[j*p + k];
+        if (!(d > 1e-12 * a[j*p + j])) return false; // pivot nul ou négligeable
+        d = std::sqrt(d);
+        a[j*p + j] = d;
+        for (size_t i = j + 1; i < p; ++i) {
+            double s = a[i*p + j];
+            for (size_t k = 0; k < j; ++k) s -= a[i*p + k] * a[j*p + k];
+            a[i*p + j] = s / d;
+        }
+    }
+    return true;
+}
+
+// Résout L L' x = b sur place (L dans le triangle inférieur de l)
+static void choleskySolve(const std::vector<double>& l, size_t p, std::vector<double>& b) {
+    for (size_t i = 0; i < p; ++i) {
+        for (size_t k = 0; k < i; ++k) b[i] -= l[i*p + k] * b[k];
+        b[i] /= l[i*p + i];
+    }
+    for (size_t i = p; i-- > 0;) {
+        for (size_t k = i + 1; k < p; ++k) b[i] -= l[k*p + i] * b[k];
+        b[i] /= l[i*p + i];
+    }
+}
+
+// --- Régression multiple (moindres carrés ordinaires) ---
+// Sur données centrées : Sxx * beta = Sxy, constante = moyY - somme(beta_i * moyXi).
+// SCR = Syy - beta' Sxy ; sigma² = SCR / (n-p-1) ;
+// Var(beta) = sigma² * diag(Sxx^-1), Var(b0) = sigma² * (1/n + moyX' Sxx^-1 moyX).
+StatInfer::MultiRegression StatInfer::regressionMultiple(ColumnView Y, const std::vector<ColumnView>& X) {
+    MultiRegression res;
+    size_t p = X.size(), n = Y.size();
+    if (p == 0 || n <= p + 1) return res;
+    std::vector<const double*> cols;
+    for (const ColumnView& x : X) {
+        if (x.size() != n) return res;
+        cols.push_back(x.data());
+    }
+    cols.push_back(Y.data()); // Y en dernière colonne
+
+    CoMomentMatrix m = Parallel::coMoments(cols, n);
+    std::vector<double> l(p * p), beta(p);
+    for (size_t i = 0; i < p; ++i) {
+        for (size_t j = 0; j < p; ++j) l[i*p + j] = m.coDev(i, j);
+        beta[i] = m.coDev(i, p);
+    }
+    if (!cholesky(l, p)) return res;
+    choleskySolve(l, p, beta);
+
+    double syy = m.coDev(p, p);
+    double ssr = syy;
+    for (size_t i = 0; i < p; ++i) ssr -= beta[i] * m.coDev(i, p);
+    if (ssr < 0) ssr = 0;
+    double dfRes = (double)(n - p - 1);
+    double sigma2 = ssr / dfRes;
+
+    res.ok = true;
+    res.n = n;
+    res.r2 = (syy > 0) ? 1.0 - ssr / syy : 0.0;
+    res.r2adj = 1.0 - (1.0 - res.r2) * (n - 1) / dfRes;
+
+    res.coef.assign(p + 1, 0.0);
+    res.stdErr.assign(p + 1, 0.0);
+    double b0 = m.mean(p);
+    for (size_t i = 0; i < p; ++i) {
+        res.coef[i + 1] = beta[i];
+        b0 -= beta[i] * m.mean(i);
+    }
+    res.coef[0] = b0;
+
+    // Colonnes de Sxx^-1 par résolutions successives
+    std::vector<double> means(p), inv(p), e(p);
+    for (size_t i = 0; i < p; ++i) means[i] = m.mean(i);
+    inv = means;
+    choleskySolve(l, p, inv);                       // Sxx^-1 * moyX
+    double q = 0.0;
+    for (size_t i = 0; i < p; ++i) q += means[i] * inv[i];
+    res.stdErr[0] = std::sqrt(sigma2 * (1.0 / n + q));
+    for (size_t i = 0; i < p; ++i) {
+        std::fill(e.begin(), e.end(), 0.0);
+        e[i] = 1.0;
+        choleskySolve(l, p, e);
+        res.stdErr[i + 1] = std::sqrt(sigma2 * e[i]);
+    }
+    return res;
+}
+
 // --- Corrélation de Pearson ---
 // Retourne 0 si tailles incompatibles ou si variance nulle.
-double StatInfer::pearson(const std::vector<double>& X, const std::vector<double>& Y) {
-    int n = X.size();
+double StatInfer::pearson(ColumnView X, ColumnView Y) {
+    size_t n = X.size();
     if(n==0 || n!=Y.size()) return 0.0;
-    double mx=0, my=0, sx=0, sy=0, num=0;
-    for(int i=0;i<n;++i){mx+=X[i];my+=Y[i];}
-    mx/=n; my/=n;
-    for(int i=0;i<n;++i){
-      sx+=(X[i]-mx)*(X[i]-mx);
-      sy+=(Y[i]-my)*(Y[i]-my);
-      num+=(X[i]-mx)*(Y[i]-my);
+    double mx = Parallel::sum(X.data(), n) / n;
+    double my = Parallel::sum(Y.data(), n) / n;
+    Kernels::CrossDev d = Parallel::crossDev(X.data(), Y.data(), n, mx, my);
+    if (d.sxx==0 || d.syy==0) return 0.0;
+    return d.sxy/std::sqrt(d.sxx*d.syy);
+}
+
+
+// --- Matrice de corrélation de Pearson ---
+// Un seul parcours des lignes pour toutes les paires (au lieu de k(k-1)/2 appels à pearson).
+std::vector<std::vector<double>> StatInfer::correlationMatrix(const std::vector<ColumnView>& cols) {
+    size_t k = cols.size();
+    std::vector<std::vector<double>> r(k, std::vector<double>(k, 0.0));
+    if (k == 0) return r;
+    size_t n = cols[0].size();
+    std::vector<const double*> ptrs;
+    for (const ColumnView& c : cols) {
+        if (c.size() != n) return r;
+        ptrs.push_back(c.data());
+    }
+    CoMomentMatrix m = Parallel::coMoments(ptrs, n);
+    for (size_t i = 0; i < k; ++i)
+        for (size_t j = 0; j < k; ++j)
+            r[i][j] = (i == j) ? (m.coDev(i, i) > 0 ? 1.0 : 0.0) : m.pearson(i, j);
+    return r;
+}
+
+// Rangs (1 = plus grande valeur) à partir de l'ordre trié en cache ;
+// un groupe d'ex-aequo reçoit la moyenne de ses positions.
+static std::vector<double> averageRanks(const SpotifyDataset& dataset, Attribute attr) {
+    ColumnView col = dataset.getAttribute(attr);
+    const std::vector<uint32_t>& order = dataset.sortedOrder(attr);
+    std::vector<double> ranks(order.size());
+    size_t i = 0;
+    while (i < order.size()) {
+        size_t j = i + 1;
+        while (j < order.size() && col[order[j]] == col[order[i]]) j++;
+        double avg = (i + 1 + j) / 2.0; // moyenne des positions i+1 .. j
+        for (size_t p = i; p < j; ++p) ranks[order[p]] = avg;
+        i = j;
     }
-    if (sx==0 || sy==0) return 0.0;
-    return num/std::sqrt(sx*sy);
+    return ranks;
 }
 
+// --- Matrice de corrélation de Spearman ---
+std::vector<std::vector<double>> StatInfer::spearmanMatrix(const SpotifyDataset& dataset, const std::vector<Attribute>& attrs) {
+    std::vector<std::vector<double>> ranks;
+    for (Attribute a : attrs) ranks.push_back(averageRanks(dataset, a));
+    std::vector<ColumnView> cols(ranks.begin(), ranks.end());
+    return correlationMatrix(cols);
+}
 
 // --- Représentation ASCII d'un nuage de points et de la droite de régression ---
 // Trace le nuage (o) et la droite (x) dans une grille width x height.
-void StatInfer::regressionAsciiPlot(const std::vector<double>& X, const std::vector<double>& Y, double a, double b, int width, int height) {
+void StatInfer::regressionAsciiPlot(ColumnView X, ColumnView Y, double a, double b, std::ostream& out, int width, int height) {
     if(X.empty()||Y.empty()||X.size()!=Y.size())
         return;
 
@@ -180,7 +395,7 @@ void StatInfer::regressionAsciiPlot(const std::vector<double>& X, const std::vec
 
     // Affichage
     for(int y=0; y<=height;++y) {
-        std::cout << grille[y] << "\n";
+        out << grille[y] << "\n";
     }
-    std::cout << "o: donnees, x: droite regression Y=aX+b\n";
+    out << "o: donnees, x: droite regression Y=aX+b\n";
 }
@@ -1,8 +1,10 @@
 #pragma once
 #include "Artist.h"
+#include "SpotifyDataset.h"
+#include "ColumnView.h"
 #include <vector>
 #include <string>
-#include <unordered_set>
+#include <iostream>
 
 /*
   StatInfer : fonctions d'inférence/statistiques (probabilités simples,
@@ -11,24 +13,63 @@
 class StatInfer {
 public:
     // PROBABILITÉS 
-    static double probaTopN(const std::vector<Artist>&, int n, const std::string& attr);
-    static double probaParSoloRatio(const std::vector<Artist>&, double seuilRatio);
-    static double probaCondTopNdaily_given_highStreams(const std::vector<Artist>&, double seuilStreams, int n);
+    static double probaTopN(const SpotifyDataset&, int n, Attribute attr);
+    static double probaParSoloRatio(const SpotifyDataset&, double seuilRatio);
+    static double probaCondTopNdaily_given_highStreams(const SpotifyDataset&, double seuilStreams, int n);
 
-    // ESTIMATIONS (IC 95% approximatifs)
-    static double intervalleConfianceMoyenne(const std::vector<double>&, double alpha=0.05);
+    // ESTIMATIONS (IC de niveau 1-alpha, approximation normale)
+    static double intervalleConfianceMoyenne(ColumnView, double alpha=0.05);
     static double intervalleConfianceProportion(int nbSuccess, int nbTotal, double alpha=0.05);
 
+    // Quantile de la loi normale centrée réduite (0 < p < 1), erreur relative < 1.2e-9
+    static double normalQuantile(double p);
+
     // TESTS (t-test, test de proportion) – renvoient la statistique de test
-    static double ttest2moyennes(const std::vector<double>&, const std::vector<double>&);
+    static double ttest2moyennes(ColumnView, ColumnView);
     static double testProportion(int nbSuccess, int nbTotal, double prop0);
 
+    // Test t de Welch complet : statistique, degrés de liberté (Welch-Satterthwaite)
+    // et p-value bilatérale tirée de la loi de Student
+    struct WelchTest {
+        double t = 0.0;
+        double df = 0.0;
+        double pValue = 1.0;
+    };
+    static WelchTest welchTest(ColumnView, ColumnView);
+
+    // LOIS : fonctions de répartition et p-values bilatérales
+    static double normalCdf(double z);
+    static double studentCdf(double t, double df);
+    static double pValueNormal(double z);            // P(|Z| >= |z|)
+    static double pValueStudent(double t, double df); // P(|T| >= |t|)
+
     // RÉGRESSION LINÉAIRE (Y = aX + b) + coefficient de détermination R²
-    static void regressionLineaire(const std::vector<double>& X, const std::vector<double>& Y, double& a, double& b, double& r2);
+    static void regressionLineaire(ColumnView X, ColumnView Y, double& a, double& b, double& r2);
+    // Même résultat depuis des co-moments déjà calculés (colonnes ix -> iy de m), O(1)
+    static void regressionLineaire(const CoMomentMatrix& m, size_t ix, size_t iy, double& a, double& b, double& r2);
+
+    // RÉGRESSION MULTIPLE (MCO) : Y = b0 + b1*X1 + ... + bp*Xp
+    struct MultiRegression {
+        bool ok = false;             // false si tailles incohérentes, n <= p+1 ou prédicteurs colinéaires
+        size_t n = 0;
+        std::vector<double> coef;    // coef[0] = constante, coef[i] = coefficient de Xi
+        std::vector<double> stdErr;  // erreurs-types, même indexation que coef
+        double r2 = 0.0;
+        double r2adj = 0.0;
+    };
+    // Équations normales centrées accumulées en un parcours par blocs (CoMomentMatrix,
+    // en parallèle), puis résolution par Cholesky.
+    static MultiRegression regressionMultiple(ColumnView Y, const std::vector<ColumnView>& X);
 
     // CORRÉLATION DE PEARSON
-    static double pearson(const std::vector<double>&, const std::vector<double>&);
+    static double pearson(ColumnView, ColumnView);
+
+    // MATRICES DE CORRÉLATION (k x k, symétriques, diagonale = 1 ou 0 si colonne constante)
+    // Pearson : toutes les paires en un seul parcours par blocs (CoMomentMatrix).
+    static std::vector<std::vector<double>> correlationMatrix(const std::vector<ColumnView>& cols);
+    // Spearman : Pearson sur les rangs, tirés des index triés du dataset (ex-aequo = rang moyen).
+    static std::vector<std::vector<double>> spearmanMatrix(const SpotifyDataset&, const std::vector<Attribute>& attrs);
 
     // TRACE ASCII d'une régression (nuage + droite ajustée)
-    static void regressionAsciiPlot(const std::vector<double>& X, const std::vector<double>& Y, double a, double b, int width=60, int height=20);
+    static void regressionAsciiPlot(ColumnView X, ColumnView Y, double a, double b, std::ostream& out = std::cout, int width=60, int height=20);
 };
@@ -0,0 +1,129 @@
+#include "StringPool.h"
+#include <cstring>
+
+StringPool::StringPool(const StringPool& o) {
+    *this = o;
+}
+
+StringPool& StringPool::operator=(const StringPool& o) {
+    if (this == &o) return *this;
+    chunks = o.chunks;
+    slotBase = o.slotBase;
+    left = 0; // la place libre du dernier bloc reste à 'o'
+    refs = o.refs;
+    std::lock_guard<std::mutex> lock(o.indexMtx);
+    slots = o.slots;
+    indexed = o.indexed.load();
+    return *this;
+}
+
+// FNV-1a 64 bits
+uint64_t StringPool::hash(std::string_view s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Bloc contigu d'au moins minBytes, arrondi à un multiple de CHUNK : chaque tranche
+// de CHUNK octets a son entrée dans slotBase, une position se résout en O(1).
+char* StringPool::newChunk(size_t minBytes) {
+    size_t nbSlices = (minBytes + CHUNK - 1) / CHUNK;
+    if (nbSlices == 0) nbSlices = 1;
+    chunks.emplace_back(new char[nbSlices * CHUNK]);
+    char* base = chunks.back().get();
+    for (size_t k = 0; k < nbSlices; ++k) slotBase.push_back(base + k * CHUNK);
+    left = nbSlices * CHUNK;
+    return base;
+}
+
+uint64_t StringPool::store(std::string_view s) {
+    if (s.size() > MAX_LENGTH) s = s.substr(0, MAX_LENGTH);
+    if (s.empty()) return 0;
+    if (s.size() > left) newChunk(s.size());
+    uint64_t pos = (uint64_t)slotBase.size() * CHUNK - left;
+    std::memcpy(slotBase[pos / CHUNK] + pos % CHUNK, s.data(), s.size());
+    left -= s.size();
+    return (pos << LENGTH_BITS) | s.size();
+}
+
+// Sondage linéaire, taille puissance de 2, facteur de charge <= 1/2
+void StringPool::rehash(size_t nbSlots) const {
+    slots.assign(nbSlots, 0);
+    size_t mask = nbSlots - 1;
+    for (uint32_t id = 0; id < refs.size(); ++id) {
+        size_t i = hash(view(id)) & mask;
+        while (slots[i] != 0) i = (i + 1) & mask;
+        slots[i] = id + 1;
+    }
+}
+
+// Construction différée après assign (double vérification : find peut être concurrent)
+void StringPool::ensureIndex() const {
+    if (indexed.load(std::memory_order_acquire)) return;
+    std::lock_guard<std::mutex> lock(indexMtx);
+    if (indexed.load(std::memory_order_relaxed)) return;
+    size_t nbSlots = 64;
+    while (nbSlots < refs.size() * 2 + 2) nbSlots *= 2;
+    rehash(nbSlots);
+    indexed.store(true, std::memory_order_release);
+}
+
+uint32_t StringPool::find(std::string_view s) const {
+    ensureIndex();
+    if (slots.empty()) return NOT_FOUND;
+    if (s.size() > MAX_LENGTH) s = s.substr(0, MAX_LENGTH);
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash(s) & mask; slots[i] != 0; i = (i + 1) & mask)
+        if (view(slots[i] - 1) == s) return slots[i] - 1;
+    return NOT_FOUND;
+}
+
+uint32_t StringPool::intern(std::string_view s) {
+    ensureIndex();
+    if (s.size() > MAX_LENGTH) s = s.substr(0, MAX_LENGTH);
+    if ((refs.size() + 1) * 2 > slots.size()) rehash(slots.empty() ? 64 : slots.size() * 2);
+    size_t mask = slots.size() - 1;
+    size_t i = hash(s) & mask;
+    for (; slots[i] != 0; i = (i + 1) & mask)
+        if (view(slots[i] - 1) == s) return slots[i] - 1;
+    uint32_t id = (uint32_t)refs.size();
+    refs.push_back(store(s));
+    slots[i] = id + 1;
+    return id;
+}
+
+bool StringPool::assign(const char* bytes, const uint64_t* offsets, size_t count) {
+    clear();
+    size_t total = (size_t)offsets[count];
+    char* base = total ? newChunk(total) : nullptr;
+    if (total) std::memcpy(base, bytes, total);
+    left -= total;
+    refs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t len = offsets[i+1] - offsets[i];
+        if (len > MAX_LENGTH) { clear(); return false; }
+        refs.push_back((offsets[i] << LENGTH_BITS) | len);
+    }
+    indexed = false;
+    return true;
+}
+
+void StringPool::clear() {
+    chunks.clear();
+    slotBase.clear();
+    left = 0;
+    refs.clear();
+    slots.clear();
+    indexed = true;
+}
+
+void StringPool::reserve(size_t nbStrings) {
+    ensureIndex();
+    refs.reserve(nbStrings);
+    size_t nbSlots = 64;
+    while (nbSlots < nbStrings * 2) nbSlots *= 2;
+    if (nbSlots > slots.size()) rehash(nbSlots);
+}
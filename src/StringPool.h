@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+/*
+  StringPool : chaînes internées dans une arène, identifiées par un id 32 bits.
+
+  Les octets sont rangés bout à bout dans des blocs de CHUNK octets (une chaîne plus
+  longue a un bloc à elle, de taille multiple de CHUNK) : une allocation par bloc au
+  lieu d'une par chaîne. Chaque id est décrit par 8 octets (position dans l'arène,
+  longueur) au lieu d'un std::string de 32 octets. Une chaîne déjà présente renvoie
+  son id existant (table de hachage à adressage ouvert sur les ids). Les vues
+  renvoyées restent valides tant que le pool, ou une copie de celui-ci, existe :
+  aucune chaîne n'est jamais déplacée.
+
+  Copie : les blocs déjà remplis sont partagés (jamais réécrits), la copie ouvre
+  son propre bloc pour ses ajouts. Coût : les tableaux d'ids, pas les octets.
+
+  Après assign (chargement d'un snapshot), la table de hachage n'est construite
+  qu'au premier find/intern : un pool seulement lu par id ne la paie jamais.
+  find est sûr en lecture concurrente ; intern/assign/clear demandent l'exclusivité.
+*/
+class StringPool {
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+    static constexpr size_t CHUNK = 64 * 1024;
+    static constexpr unsigned LENGTH_BITS = 24;
+    static constexpr size_t MAX_LENGTH = (size_t(1) << LENGTH_BITS) - 1; // au-delà : tronquée
+
+    StringPool() = default;
+    StringPool(const StringPool& other);
+    StringPool& operator=(const StringPool& other);
+
+    // Id de s, ajoutée si absente
+    uint32_t intern(std::string_view s);
+    // Id de s ou NOT_FOUND, sans ajout
+    uint32_t find(std::string_view s) const;
+
+    // Remplace le contenu par 'count' chaînes déjà distinctes : la i-ème occupe
+    // bytes[offsets[i], offsets[i+1]). Une seule allocation pour tous les octets.
+    // false (pool vidé) si une chaîne dépasse MAX_LENGTH.
+    bool assign(const char* bytes, const uint64_t* offsets, size_t count);
+
+    std::string_view view(uint32_t id) const {
+        uint64_t r = refs[id];
+        size_t len = (size_t)(r & MAX_LENGTH);
+        if (len == 0) return std::string_view();
+        uint64_t pos = r >> LENGTH_BITS;
+        return std::string_view(slotBase[pos / CHUNK] + pos % CHUNK, len);
+    }
+    size_t size() const { return refs.size(); }
+    size_t bytes() const { return slotBase.size() * CHUNK; } // octets réservés par les blocs
+
+    void clear();
+    void reserve(size_t nbStrings);
+
+private:
+    std::vector<std::shared_ptr<char[]>> chunks; // propriété des blocs (partagés entre copies)
+    std::vector<char*> slotBase;  // début de chaque tranche de CHUNK octets de l'arène
+    size_t left = 0;              // place libre à la fin de la dernière tranche
+
+    std::vector<uint64_t> refs;   // id -> (position << LENGTH_BITS) | longueur
+    mutable std::vector<uint32_t> slots; // table de hachage : id + 1, 0 = vide
+    mutable std::atomic<bool> indexed{true}; // false : slots à reconstruire
+    mutable std::mutex indexMtx;
+
+    static uint64_t hash(std::string_view s);
+    uint64_t store(std::string_view s);
+    char* newChunk(size_t minBytes); // ajoute un bloc, renvoie son début
+    void rehash(size_t nbSlots) const;
+    void ensureIndex() const;
+};
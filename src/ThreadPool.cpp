@@ -0,0 +1,111 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include <memory>
+
+thread_local bool ThreadPool::insideWorker = false;
+
+ThreadPool::ThreadPool(unsigned nbThreads) : stopping(false) {
+    if (nbThreads == 0) nbThreads = std::thread::hardware_concurrency();
+    if (nbThreads == 0) nbThreads = 1;
+    // Le thread appelant participe aussi : on lance nbThreads-1 workers
+    for (unsigned i = 1; i < nbThreads; ++i)
+        workers.emplace_back([this] { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+unsigned ThreadPool::size() const {
+    return (unsigned)workers.size() + 1;
+}
+
+void ThreadPool::workerLoop() {
+    insideWorker = true;
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+}
+
+// Les tâches sont distribuées par un compteur atomique partagé : chaque participant
+// prend l'indice suivant tant qu'il en reste (équilibrage dynamique).
+void ThreadPool::parallelFor(size_t nbTasks, const std::function<void(size_t)>& fn) {
+    if (nbTasks == 0) return;
+    if (insideWorker || workers.empty() || nbTasks == 1) {
+        for (size_t i = 0; i < nbTasks; ++i) fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr firstError;
+    std::mutex errorMtx;
+
+    auto run = [&] {
+        size_t i;
+        while ((i = next.fetch_add(1)) < nbTasks) {
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMtx);
+                if (!firstError) firstError = std::current_exception();
+            }
+        }
+    };
+
+    size_t nbHelpers = std::min(workers.size(), nbTasks - 1);
+    std::mutex doneMtx;
+    std::condition_variable doneCv;
+    size_t remaining = nbHelpers;
+    for (size_t h = 0; h < nbHelpers; ++h) {
+        submit([&] {
+            run();
+            std::lock_guard<std::mutex> lock(doneMtx);
+            if (--remaining == 0) doneCv.notify_one();
+        });
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(doneMtx);
+    doneCv.wait(lock, [&] { return remaining == 0; });
+    lock.unlock();
+
+    if (firstError) std::rethrow_exception(firstError);
+}
+
+static std::unique_ptr<ThreadPool> globalPool;
+static std::mutex globalMtx;
+
+ThreadPool& ThreadPool::global() {
+    std::lock_guard<std::mutex> lock(globalMtx);
+    if (!globalPool) globalPool.reset(new ThreadPool());
+    return *globalPool;
+}
+
+void ThreadPool::setGlobalSize(unsigned nbThreads) {
+    std::lock_guard<std::mutex> lock(globalMtx);
+    globalPool.reset();                      // joint les anciens workers
+    globalPool.reset(new ThreadPool(nbThreads));
+}
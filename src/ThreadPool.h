@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstddef>
+
+/*
+  ThreadPool : pool de threads à taille fixe.
+
+  parallelFor(n, fn) exécute fn(0) ... fn(n-1) sur les workers ET sur le thread
+  appelant, puis attend la fin de toutes les tâches. L'ordre d'exécution n'est pas
+  garanti : chaque tâche doit écrire dans sa propre case de résultat.
+  Appelé depuis un worker du pool, parallelFor s'exécute séquentiellement sur place
+  (évite l'interblocage en cas d'imbrication).
+*/
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping;
+
+    static thread_local bool insideWorker;
+
+    void workerLoop();
+    void submit(std::function<void()> task);
+
+public:
+    // nbThreads = 0 -> std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned nbThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Nombre de threads participant à un parallelFor (workers + thread appelant)
+    unsigned size() const;
+
+    // Exécute fn(i) pour i dans [0, nbTasks). Relance la première exception levée.
+    void parallelFor(size_t nbTasks, const std::function<void(size_t)>& fn);
+
+    // Pool partagé par tout le programme (taille par défaut : hardware_concurrency)
+    static ThreadPool& global();
+
+    // Recrée le pool partagé avec nbThreads threads (0 -> défaut). À appeler entre
+    // deux calculs : les références obtenues par global() deviennent invalides.
+    // Un rechargement en arrière-plan utilise le pool : voir DatasetHolder::runExclusive.
+    static void setGlobalSize(unsigned nbThreads);
+};
@@ -0,0 +1,144 @@
+/*
+  client : envoie des commandes à un serveur lancé par "main --serve".
+
+  Usage : client unix:/chemin|tcp:PORT [commande ...]
+    - avec une commande en arguments : l'envoie et affiche la réponse ;
+    - sinon : une commande par ligne lue sur stdin, réponses dans l'ordre.
+  Réponses au format "OK <taille>\n" suivi de <taille> octets.
+*/
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#error "client : systemes POSIX uniquement (serveur Linux, voir MakeFile.sh)"
+#else
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <charconv>
+
+static int connectTo(const std::string& address) {
+    if (address.rfind("unix:", 0) == 0) {
+        std::string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) return -1;
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) { close(fd); return -1; }
+        return fd;
+    }
+    if (address.rfind("tcp:", 0) == 0) {
+        int port = std::atoi(address.c_str() + 4);
+        if (port <= 0 || port > 65535) return -1;
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) { close(fd); return -1; }
+        return fd;
+    }
+    return -1;
+}
+
+static bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t w = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (w <= 0) return false;
+        sent += (size_t)w;
+    }
+    return true;
+}
+
+// Lit une réponse "OK <taille>\n<payload>" ; 'pending' garde les octets déjà reçus
+static bool readResponse(int fd, std::string& pending, std::string& payload) {
+    char buf[4096];
+    size_t nl;
+    while ((nl = pending.find('\n')) == std::string::npos) {
+        ssize_t r = read(fd, buf, sizeof(buf));
+        if (r <= 0) return false;
+        pending.append(buf, (size_t)r);
+    }
+    std::string header = pending.substr(0, nl);
+    if (header.rfind("OK ", 0) != 0) return false;
+    size_t len = 0;
+    const char* end = header.data() + header.size();
+    auto [ptr, ec] = std::from_chars(header.data() + 3, end, len);
+    if (ec != std::errc() || ptr != end) return false; // taille absente ou suivie d'autre chose
+    pending.erase(0, nl + 1);
+    while (pending.size() < len) {
+        ssize_t r = read(fd, buf, sizeof(buf));
+        if (r <= 0) return false;
+        pending.append(buf, (size_t)r);
+    }
+    payload = pending.substr(0, len);
+    pending.erase(0, len);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage : client unix:/chemin|tcp:PORT [commande ...]\n";
+        return 1;
+    }
+    int fd = connectTo(argv[1]);
+    if (fd < 0) {
+        std::cout << "Connexion impossible a " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::vector<std::string> commands;
+    if (argc > 2) {
+        std::string command;
+        for (int i = 2; i < argc; ++i) command += (i > 2 ? " " : "") + std::string(argv[i]);
+        commands.push_back(command);
+    } else {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            commands.push_back(line);
+        }
+    }
+
+    // Commandes envoyées par avance, au plus WINDOW sans réponse : le serveur cesse
+    // de lire une connexion dont les réponses s'accumulent, un envoi d'un seul bloc
+    // pourrait alors bloquer des deux côtés. Les réponses arrivent dans l'ordre.
+    const size_t WINDOW = 32;
+    size_t sent = 0;
+    std::string pending, payload;
+    int status = 0;
+    for (size_t i = 0; i < commands.size(); ++i) {
+        if (sent < commands.size() && sent <= i + WINDOW / 2) { // fenêtre à moitié vide : compléter
+            std::string request;
+            for (; sent < commands.size() && sent < i + WINDOW; ++sent) request += commands[sent] + "\n";
+            if (!sendAll(fd, request)) {
+                std::cout << "Erreur d'envoi\n";
+                status = 1;
+                break;
+            }
+        }
+        if (!readResponse(fd, pending, payload)) {
+            std::cout << "Reponse invalide ou connexion fermee\n";
+            status = 1;
+            break;
+        }
+        if (commands.size() > 1) std::cout << "> " << commands[i] << '\n';
+        std::cout << payload;
+    }
+    close(fd);
+    return status;
+}
+
+#endif
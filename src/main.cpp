@@ -2,12 +2,37 @@
 #include "SpotifyDataset.h"
 #include "StatDesc.h"
 #include "StatInfer.h"
+#include "OnlineStats.h"
+#include "ThreadPool.h"
+#include "Resampling.h"
+#include "QueryCache.h"
+#include "QueryServer.h"
+#include "DatasetHolder.h"
+#include "Expression.h"
+#include "Query.h"
 
 // Les bibliothèques necessaires à la lecture et sauvegarde de fichier + vector
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <vector>
+#include <iomanip>
+#include <filesystem>
+#include <memory>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+// Détection d'une entrée redirigée (mode batch automatique)
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
 
 // CODES COULEUR ANSI (vert rétro)
 #define COLOR_GREEN   "\033[1;32m"
@@ -18,30 +43,126 @@
 std::string lastResult; // Pour la sauvegarde
 
 // ------------------------------------------------------------
-// Commandes "desc" : stats descriptives sur un attribut
-// Usage : desc [mean|median|mode|min|max|variance|stddev] [attribut]
+// Résolution d'un nom d'attribut, une fois à l'entrée de la commande.
+// Nom inconnu -> message d'erreur dans lastResult et false.
 // ------------------------------------------------------------
-void handleDescCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& lastResult) {
-    if (args.size() != 3) {
-        lastResult = "Usage : desc [mean|median|mode|min|max|variance|stddev|amplitude] [attribut]\n";
-        std::cout << lastResult;
+bool resolveAttribute(const std::string& name, Attribute& attr, std::string& result) {
+    if (parseAttribute(name, attr)) return true;
+    result = "Attribut inconnu : " + name + " (attendu : " + attributeList() + ")\n";
+    return false;
+}
+
+// ------------------------------------------------------------
+// Colonne d'une commande : attribut (colonne du dataset, agrégats et index
+// triés disponibles) ou expression dérivée ("solo/streams", "abs(aslead-asfeature)",
+// "log(streams)") évaluée une fois par lots. Une expression s'écrit sans espace.
+// ------------------------------------------------------------
+struct ResolvedColumn {
+    bool isAttribute = false;
+    Attribute attr = Attribute::Streams;
+    std::vector<double> values; // valeurs calculées (expression, ou copie filtrée)
+    ColumnView view;            // colonne du dataset ou 'values'
+    size_t nonFinite = 0;       // lignes NaN / inf (ex : division par zéro)
+};
+
+bool resolveColumn(const SpotifyDataset& dataset, const std::string& text, ResolvedColumn& col, std::string& result) {
+    Attribute a;
+    bool bareName = std::all_of(text.begin(), text.end(),
+                                [](char c) { return std::isalnum((unsigned char)c) || c == '_'; });
+    if (bareName) { // nom seul : message habituel si l'attribut est inconnu
+        if (!resolveAttribute(text, a, result)) return false;
+        col.isAttribute = true;
+        col.attr = a;
+        col.view = dataset.getAttribute(a);
+        return true;
+    }
+    Expression expr;
+    std::string error;
+    if (!expr.compile(text, error)) {
+        result = "Attribut ou expression invalide : " + text + " (" + error + ")\n";
+        return false;
+    }
+    if (expr.isColumn(a)) { // "(streams)", "STREAMS" : colonne seule
+        col.isAttribute = true;
+        col.attr = a;
+        col.view = dataset.getAttribute(a);
+        return true;
+    }
+    col.values = expr.evaluateAll(dataset);
+    col.view = col.values;
+    for (double v : col.values)
+        if (!std::isfinite(v)) col.nonFinite++;
+    return true;
+}
+
+// Garde les lignes où toutes les colonnes sont finies (mêmes lignes pour toutes :
+// les couples restent alignés). Sans valeur non définie, rien n'est copié.
+// Renvoie le nombre de lignes écartées.
+size_t keepFiniteRows(const std::vector<ResolvedColumn*>& cols) {
+    bool any = false;
+    for (const ResolvedColumn* c : cols) any |= (c->nonFinite > 0);
+    if (!any || cols.empty()) return 0;
+    size_t n = cols[0]->view.size();
+    std::vector<char> keep(n, 1);
+    for (const ResolvedColumn* c : cols)
+        for (size_t i = 0; i < n; ++i)
+            if (!std::isfinite(c->view[i])) keep[i] = 0;
+    size_t dropped = 0;
+    for (size_t i = 0; i < n; ++i) dropped += !keep[i];
+    for (ResolvedColumn* c : cols) {
+        std::vector<double> filtered;
+        filtered.reserve(n - dropped);
+        for (size_t i = 0; i < n; ++i)
+            if (keep[i]) filtered.push_back(c->view[i]);
+        c->values.swap(filtered);
+        c->view = c->values;
+        c->isAttribute = false; // les agrégats du dataset ne correspondent plus
+        c->nonFinite = 0;
+    }
+    return dropped;
+}
+
+// ------------------------------------------------------------
+// Commandes "desc" : stats descriptives sur un attribut ou une expression
+// Usage : desc [mean|median|mode|min|max|variance|stddev|all|percentiles] [attribut]
+//         desc quantile p [attribut]
+//         desc heavy K [attribut]
+// ------------------------------------------------------------
+void handleDescCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
+    // Stats avec paramètre : "desc quantile p attr", "desc heavy K attr"
+    bool hasParam = (args.size() == 4 && (args[1] == "quantile" || args[1] == "heavy"));
+    if (args.size() != 3 && !hasParam) {
+        result = "Usage : desc [mean|median|mode|min|max|variance|stddev|amplitude|all|percentiles] [attribut]\n"
+                     "     ou desc quantile p [attribut]   (0 <= p <= 1)\n"
+                     "     ou desc heavy K [attribut]      (K valeurs les plus frequentes, approx.)\n";
         return;
     }
     std::ostringstream oss;
     std::string stat = args[1];
-    std::string attr = args[2];
+    std::string attr = hasParam ? args[3] : args[2];
 
-    // Récupère toutes les valeurs de l'attribut voulu
-    std::vector<double> data = dataset.getAttribute(attr);
+    // Récupère toutes les valeurs de l'attribut (ou de l'expression) voulu
+    ResolvedColumn rc;
+    if (!resolveColumn(dataset, attr, rc, result)) return;
+    size_t dropped = keepFiniteRows({&rc});
+    if (dropped > 0)
+        oss << "(" << dropped << " ligne(s) ou " << attr << " n'est pas definie ignoree(s))\n";
+    ColumnView data = rc.view;
     if (data.empty()) {
-        lastResult = "Attribut inconnu ou vide.\n";
-        std::cout << lastResult;
+        result = "Aucune donnee.\n";
         return;
     }
 
+    // mean / variance / stddev : lus dans les agrégats tenus à jour par le dataset
+    // pour un attribut, calculés sur les valeurs pour une expression
+    const CoMomentMatrix& agg = dataset.aggregates();
+    size_t col = (size_t)rc.attr;
+    double variance = (stat == "variance" || stat == "stddev" || stat == "ecarttype")
+        ? (rc.isAttribute ? agg.covariance(col, col) : StatDesc::variance(data)) : 0.0;
+
     // Applique la statistique demandée
     if (stat == "mean") 
-        oss << "Moyenne de " << attr << ": " << StatDesc::mean(data) << '\n';
+        oss << "Moyenne de " << attr << ": " << (rc.isAttribute ? agg.mean(col) : StatDesc::mean(data)) << '\n';
     else if (stat == "median")
         oss << "Mediane de " << attr << ": " << StatDesc::median(data) << '\n';
     else if (stat == "mode") {
@@ -57,14 +178,52 @@ void handleDescCommand(const SpotifyDataset& dataset, const std::vector<std::str
     else if (stat == "amplitude")
         oss << "Amplitude de " << attr << ": " << StatDesc::amplitude(data) << '\n';
     else if (stat == "variance")
-        oss << "Variance de " << attr << ": " << StatDesc::variance(data) << '\n';
+        oss << "Variance de " << attr << ": " << variance << '\n';
     else if (stat == "stddev" || stat == "ecarttype")
-        oss << "Ecart-type de " << attr << ": " << StatDesc::stddev(data) << '\n';
+        oss << "Ecart-type de " << attr << ": " << std::sqrt(variance) << '\n';
+    else if (stat == "quantile") {
+        double p = std::stod(args[2]);
+        if (p < 0.0 || p > 1.0)
+            oss << "Le quantile doit etre entre 0 et 1.\n";
+        else
+            oss << "Quantile " << p << " de " << attr << ": " << StatDesc::quantile(data, p) << '\n';
+    }
+    else if (stat == "heavy") {
+        int k = std::stoi(args[2]);
+        if (k <= 0) {
+            oss << "K doit etre positif.\n";
+        } else {
+            std::vector<StatDesc::HeavyHitter> top = StatDesc::heavyHitters(data, k);
+            oss << "Valeurs frequentes (approx. Space-Saving, K=" << k << ") de " << attr << " :\n";
+            for (const auto& h : top)
+                oss << "  " << h.value << " : " << h.count << " (erreur max " << h.error << ")\n";
+        }
+    }
+    else if (stat == "percentiles") {
+        // p50/p90/p99 en une seule multi-sélection
+        std::vector<double> q = StatDesc::quantiles(data, {0.50, 0.90, 0.99});
+        oss << "Percentiles de " << attr << ": p50=" << q[0]
+            << " ; p90=" << q[1] << " ; p99=" << q[2] << '\n';
+    }
+    else if (stat == "all") {
+        // Toutes les stats "à un passage" en un seul parcours des données
+        StatDesc::Summary s = StatDesc::summary(data);
+        oss << "Resume de " << attr << " :\n"
+            << "  effectif  : " << s.count << '\n'
+            << "  somme     : " << s.sum << '\n'
+            << "  moyenne   : " << s.mean << '\n'
+            << "  variance  : " << s.variance() << '\n'
+            << "  ecart-type: " << s.stddev() << '\n'
+            << "  minimum   : " << s.min << '\n'
+            << "  maximum   : " << s.max << '\n'
+            << "  amplitude : " << s.amplitude() << '\n'
+            << "  asymetrie : " << s.skewness << '\n'
+            << "  kurtosis  : " << s.kurtosis << " (excès)\n";
+    }
     else
         oss << "Stat inconnue.\n";
 
-    lastResult = oss.str();
-    std::cout << lastResult;   
+    result = oss.str();
 }
 
 // ------------------------------------------------------------
@@ -72,130 +231,253 @@ void handleDescCommand(const SpotifyDataset& dataset, const std::vector<std::str
 //  - top N [attribut]
 //  - top gapleadfeature N
 // ------------------------------------------------------------
-void handleTopCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& lastResult) {
+void handleTopCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
     std::ostringstream oss;
     if (!(args.size() == 3 || args.size() == 4)) {
         oss << "Usage : top 10 [attribut]\n      ou top gapleadfeature 10\n";
-        lastResult = oss.str(); std::cout << lastResult; return;
+        result = oss.str(); return;
     }
     // Cas "top gapleadfeature N"
     if (args[1] == "gapleadfeature" && args.size() == 3) {
         int n = std::stoi(args[2]);
-        auto top = StatDesc::topGapLeadFeature(dataset.getArtists(), n);
+        std::vector<size_t> top = StatDesc::topGapLeadFeature(dataset, n);
+        ColumnView lead = dataset.getAttribute(Attribute::AsLead);
+        ColumnView feat = dataset.getAttribute(Attribute::AsFeature);
         oss << "Top " << n << " ecart |asLead - asFeature|:\n";
         int i = 1;
-        for (const auto& a : top)
-            oss << i++ << ". " << a.getName()
-                      << " (asLead=" << a.getAsLead()
-                      << ", asFeature=" << a.getAsFeature()
-                      << ", ecart=" << std::abs(a.getAsLead()-a.getAsFeature()) << ")\n";
-        lastResult = oss.str(); std::cout << lastResult; return;
+        for (size_t row : top)
+            oss << i++ << ". " << dataset.getName(row)
+                      << " (asLead=" << lead[row]
+                      << ", asFeature=" << feat[row]
+                      << ", ecart=" << std::abs(lead[row]-feat[row]) << ")\n";
+        result = oss.str(); return;
     }
 
-    // Cas "top N attribut"
+    // Cas "top N attribut|expression" : colonne résolue une fois, utilisée pour le tri et l'affichage
     int n = std::stoi(args[1]);
     std::string attr = args[2];
-    auto top = StatDesc::topN(dataset.getArtists(), n, attr);
+    ResolvedColumn rc;
+    if (!resolveColumn(dataset, attr, rc, result)) return;
+    ColumnView col = rc.view;
+    std::vector<size_t> top;
+    if (rc.isAttribute) {
+        top = StatDesc::topN(dataset, n, rc.attr); // index trié du dataset
+    } else if (rc.nonFinite == 0) {
+        top = StatDesc::topN(col, n);
+    } else {
+        // Lignes non définies écartées du classement (NaN casserait l'ordre)
+        std::vector<double> finite;
+        std::vector<size_t> rows;
+        for (size_t i = 0; i < col.size(); ++i)
+            if (std::isfinite(col[i])) { finite.push_back(col[i]); rows.push_back(i); }
+        for (size_t k : StatDesc::topN(finite, n)) top.push_back(rows[k]);
+    }
     oss << "Top " << n << " artistes selon " << attr << " :\n";
     int i = 1;
-    for (const auto& a : top){
-        oss << i++ << ". " << a.getName() << " (" << attr << " = ";
-        if      (attr == "streams")     oss << a.getStreams();
-        else if (attr == "daily")       oss << a.getDaily();
-        else if (attr == "solo")        oss << a.getSolo();
-        else if (attr == "aslead" || attr == "as_lead") oss << a.getAsLead();
-        else if (attr == "asfeature" || attr == "as_feature") oss << a.getAsFeature();
-        oss << ")\n";
-    }
-    lastResult = oss.str(); std::cout << lastResult;
+    for (size_t row : top)
+        oss << i++ << ". " << dataset.getName(row) << " (" << attr << " = " << col[row] << ")\n";
+    result = oss.str();
+}
+
+// ------------------------------------------------------------
+// Commande "rank" : rang d'un artiste selon un attribut
+//  - rank [attribut] [nom de l'artiste]
+// ------------------------------------------------------------
+void handleRankCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
+    std::ostringstream oss;
+    if (args.size() < 3) {
+        oss << "Usage : rank [attribut] [nom de l'artiste]\n";
+        result = oss.str(); return;
+    }
+    Attribute attr;
+    if (!resolveAttribute(args[1], attr, result)) return;
+    // Le nom peut contenir des espaces : on recolle les tokens restants
+    std::string name = args[2];
+    for (size_t i = 3; i < args.size(); ++i) name += " " + args[i];
+
+    long row = dataset.findArtist(name); // index des noms du pool, O(1)
+    if (row < 0) {
+        oss << "Artiste introuvable : " << name << "\n";
+        result = oss.str(); return;
+    }
+    oss << name << " est " << (dataset.rankOf(attr, (size_t)row) + 1) << "e sur "
+        << dataset.size() << " selon " << args[1]
+        << " (" << args[1] << " = " << dataset.getAttribute(attr)[row] << ")\n";
+    result = oss.str();
 }
 
 // ------------------------------------------------------------
 // Affichage du ratio solo/feature par artiste
 // ------------------------------------------------------------
-void handleRepartitionCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& lastResult) {
+void handleRepartitionCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
     if(args.size() != 1) {
-        std::cout << "Usage : repartition\n";
+        result = "Usage : repartition\n";
         return;
     }
-    // Affiche directement sur la sortie standard
-    StatDesc::printSoloFeatureRatio(dataset.getArtists());
+    std::ostringstream oss;
+    StatDesc::printSoloFeatureRatio(dataset, oss);
+    result = oss.str();
 }
 
 // ------------------------------------------------------------
 // Affichage de la répartition globale solo/feature
 // ------------------------------------------------------------
-void handleGlobalRepartitionCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& lastResult) {
+void handleGlobalRepartitionCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
     if(args.size() != 2 || args[1] != "global") {
-        std::cout << "Usage : repartition global\n";
+        result = "Usage : repartition global\n";
         return;
     }
-    // Affiche directement
-    StatDesc::printGlobalSoloFeatureRatio(dataset.getArtists());
+    std::ostringstream oss;
+    StatDesc::printGlobalSoloFeatureRatio(dataset, oss);
+    result = oss.str();
 }
 
 // ------------------------------------------------------------
 // IC sur la moyenne d'un attribut (95%)
 // ------------------------------------------------------------
-void handleICMeanCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& lastResult) {
+void handleICMeanCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
     if (args.size() != 3) {
-        std::cout << "Usage : ic mean [attribut]\n";
+        result = "Usage : ic mean [attribut]\n";
         return;
     }
-    auto data = dataset.getAttribute(args[2]);
+    Attribute attr;
+    if (!resolveAttribute(args[2], attr, result)) return;
+    auto data = dataset.getAttribute(attr);
     double demiLargeur = StatInfer::intervalleConfianceMoyenne(data); // 95% => z=1,96
     double moyenne = StatDesc::mean(data);
     std::ostringstream oss;
     oss << "IC 95% pour la moyenne de " << args[2] << " : [" 
         << (moyenne-demiLargeur) << " ; " << (moyenne+demiLargeur) << "]\n";
-    lastResult = oss.str();
-    std::cout << lastResult;
+    result = oss.str();
+}
+
+// ------------------------------------------------------------
+// IC bootstrap (percentiles)
+// Usage : ic boot [mean|median] [attribut] [B] [alpha]
+//         ic boot [pearson|slope] [X] [Y] [B] [alpha]
+// B = nombre de réplicats (défaut 1000), alpha = 1 - niveau (défaut 0.05)
+// ------------------------------------------------------------
+void handleICBootCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
+    Resampling::Statistic stat;
+    if (args.size() < 4 || !Resampling::parseStatistic(args[2], stat)) {
+        result = "Usage : ic boot [mean|median] [attribut] [B] [alpha]\n"
+                     "     ou ic boot [pearson|slope] [X] [Y] [B] [alpha]\n";
+        return;
+    }
+    size_t nbCols = (size_t)Resampling::arity(stat);
+    size_t first = 3 + nbCols; // position de B
+    if (args.size() < first || args.size() > first + 2) {
+        result = "Nombre d'arguments incorrect pour ic boot " + args[2] + ".\n";
+        return;
+    }
+    Attribute ax, ay = Attribute::Streams;
+    if (!resolveAttribute(args[3], ax, result)) return;
+    if (nbCols == 2 && !resolveAttribute(args[4], ay, result)) return;
+
+    long long replicates = 1000;
+    double alpha = 0.05;
+    try {
+        if (args.size() > first) replicates = std::stoll(args[first]);
+        if (args.size() > first + 1) alpha = std::stod(args[first + 1]);
+    } catch (...) {
+        replicates = -1;
+    }
+    if (replicates <= 0 || alpha <= 0.0 || alpha >= 1.0) {
+        result = "B doit etre positif et alpha dans ]0;1[.\n";
+        return;
+    }
+
+    Resampling::Interval ic = Resampling::bootstrap(stat, dataset.getAttribute(ax), dataset.getAttribute(ay),
+                                                    (size_t)replicates, alpha);
+    std::ostringstream oss;
+    oss << "IC bootstrap " << (1.0 - alpha) * 100 << "% (percentiles, B=" << ic.replicates << ") pour "
+        << args[2] << " de " << args[3];
+    if (nbCols == 2) oss << ", " << args[4];
+    oss << " : [" << ic.lower << " ; " << ic.upper << "] (estimation " << ic.estimate << ")\n";
+    result = oss.str();
 }
 
 // ------------------------------------------------------------
 // IC sur une proportion (95%), pour "x > seuil"
 // ------------------------------------------------------------
-void handleICPropCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& lastResult) {
+void handleICPropCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
     if (args.size() != 4) {
-        std::cout << "Usage : ic prop [attribut] [seuil]\n";
+        result = "Usage : ic prop [attribut] [seuil]\n";
         return;
     }
     double seuil = std::stod(args[3]);
-    auto data = dataset.getAttribute(args[2]);
-    int nb = 0;
-    for(auto x : data) if(x > seuil) nb++;
+    Attribute attr;
+    if (!resolveAttribute(args[2], attr, result)) return;
+    auto data = dataset.getAttribute(attr);
+    int nb = dataset.countGreater(attr, seuil); // recherche dichotomique dans l'index trié
     int n = data.size();
     double demiLargeur = StatInfer::intervalleConfianceProportion(nb, n);
     double prop = n==0 ? 0 : (nb/(double)n);
     std::ostringstream oss;
     oss << "IC 95% pour la proportion d'artistes avec " << args[2] << " > " << seuil << " : ["
         << (prop - demiLargeur) << " ; " << (prop + demiLargeur) << "]\n";
-    lastResult = oss.str();
-    std::cout << lastResult;
+    result = oss.str();
 }
 
 // ------------------------------------------------------------
 // Test de proportion (z-test) : H0: p = p0
 // ------------------------------------------------------------
-void handleTestPropCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& lastResult) {
+void handleTestPropCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
     if (args.size() != 5) {
-        std::cout << "Usage : test testprop [attribut] [seuil] [proportion_attendue]\n";
+        result = "Usage : test testprop [attribut] [seuil] [proportion_attendue]\n";
         return;
     }
-    std::string attr = args[2];
+    Attribute attr;
+    if (!resolveAttribute(args[2], attr, result)) return;
     double seuil = std::stod(args[3]);
     double p0 = std::stod(args[4]);
     auto data = dataset.getAttribute(attr);
-    int nb = 0;
-    for(auto x : data) if(x > seuil) nb++;
+    int nb = dataset.countGreater(attr, seuil);
     int n = data.size();
     double z = StatInfer::testProportion(nb, n, p0);
 
     std::ostringstream oss;
     oss << "Test de proportion (H0: p = " << p0 << ") :\n";
-    oss << "z = " << z << " (>1.96 ou <-1.96 = significatif à 5%)\n";
-    lastResult = oss.str();
-    std::cout << lastResult;
+    oss << "z = " << z << " ; p-value bilaterale = " << StatInfer::pValueNormal(z) << "\n";
+    result = oss.str();
+}
+
+// ------------------------------------------------------------
+// Test de permutation sur la différence des moyennes de deux attributs
+// Usage : test perm [X] [Y] [N] [alpha]   (défaut : solo asfeature 10000 0.05)
+// ------------------------------------------------------------
+void handlePermTestCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
+    if (args.size() != 2 && (args.size() < 4 || args.size() > 6)) {
+        result = "Usage : test perm [X] [Y] [N] [alpha]\n";
+        return;
+    }
+    std::string nx = "solo", ny = "asfeature";
+    if (args.size() >= 4) { nx = args[2]; ny = args[3]; }
+    Attribute ax, ay;
+    if (!resolveAttribute(nx, ax, result) || !resolveAttribute(ny, ay, result)) return;
+
+    long long maxPerm = 10000;
+    double alpha = 0.05;
+    try {
+        if (args.size() >= 5) maxPerm = std::stoll(args[4]);
+        if (args.size() >= 6) alpha = std::stod(args[5]);
+    } catch (...) {
+        maxPerm = -1;
+    }
+    if (maxPerm <= 0 || alpha <= 0.0 || alpha >= 1.0) {
+        result = "N doit etre positif et alpha dans ]0;1[.\n";
+        return;
+    }
+
+    Resampling::PermutationTest r = Resampling::permutationTest(dataset.getAttribute(ax), dataset.getAttribute(ay),
+                                                                (size_t)maxPerm, alpha);
+    std::ostringstream oss;
+    oss << "Test de permutation (moyenne " << nx << " - moyenne " << ny << ") :\n"
+        << "difference observee = " << r.observed << "\n"
+        << "p-value = " << r.pValue << " (" << r.permutations << " permutations"
+        << (r.earlyStop ? ", arret anticipe : decision acquise" : "") << ")\n"
+        << ((r.pValue < alpha) ? "Significatif" : "Non significatif") << " au seuil " << alpha << "\n";
+    result = oss.str();
 }
 
 // ------------------------------------------------------------
@@ -209,12 +491,148 @@ std::vector<std::string> split(const std::string& s) {
     return out;
 }
 
-void saveToFile(const std::string& filename, const std::string& content) {
+// Renvoie le message à afficher (succès ou erreur)
+std::string saveToFile(const std::string& filename, const std::string& content) {
     std::ofstream out(filename);
-    if (!out) { std::cout << "Erreur d'ouverture du fichier : " << filename << "\n"; return; }
+    if (!out) return "Erreur d'ouverture du fichier : " + filename + "\n";
     out << content;
     out.close();
-    std::cout << "Résultat(s) sauvegardé(s) dans " << filename << "\n";
+    return "Résultat(s) sauvegardé(s) dans " + filename + "\n";
+}
+
+// ------------------------------------------------------------
+// Commande "regression" à plusieurs prédicteurs
+// Usage : regression Y X1 X2 ...   (au moins deux prédicteurs)
+// ------------------------------------------------------------
+void handleMultiRegressionCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
+    std::vector<ResolvedColumn> cols(args.size() - 1); // Y puis X1, X2, ...
+    std::vector<ResolvedColumn*> ptrs;
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (!resolveColumn(dataset, args[i], cols[i - 1], result)) return;
+        ptrs.push_back(&cols[i - 1]);
+    }
+    size_t dropped = keepFiniteRows(ptrs);
+    std::vector<ColumnView> xs;
+    for (size_t i = 1; i < cols.size(); ++i) xs.push_back(cols[i].view);
+
+    StatInfer::MultiRegression r = StatInfer::regressionMultiple(cols[0].view, xs);
+    std::ostringstream oss;
+    if (dropped > 0) oss << "(" << dropped << " ligne(s) non definie(s) ignoree(s))\n";
+    if (!r.ok) {
+        oss << "Regression impossible (pas assez de lignes ou predicteurs colineaires).\n";
+        result = oss.str();
+        return;
+    }
+
+    oss << "Regression multiple de " << args[1] << " (n=" << r.n << ")\n";
+    oss << std::setw(12) << "" << std::setw(16) << "coefficient" << std::setw(16) << "erreur-type" << std::setw(10) << "t" << '\n';
+    for (size_t i = 0; i < r.coef.size(); ++i) {
+        const std::string& name = (i == 0) ? std::string("constante") : args[i + 1];
+        double t = (r.stdErr[i] > 0) ? r.coef[i] / r.stdErr[i] : 0.0;
+        oss << std::setw(12) << name << std::setw(16) << r.coef[i] << std::setw(16) << r.stdErr[i]
+            << std::setw(10) << t << '\n';
+    }
+    oss << "R^2 = " << r.r2 << " ; R^2 ajuste = " << r.r2adj << '\n';
+    result = oss.str();
+}
+
+// ------------------------------------------------------------
+// Commande "correlation matrix" : toutes les paires d'attributs
+// Usage : correlation matrix [pearson|spearman]
+// ------------------------------------------------------------
+void handleCorrelationMatrixCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
+    std::string method = (args.size() >= 3) ? args[2] : "pearson";
+    if (args.size() > 3 || (method != "pearson" && method != "spearman")) {
+        result = "Usage : correlation matrix [pearson|spearman]\n";
+        return;
+    }
+
+    std::vector<Attribute> attrs;
+    std::vector<ColumnView> cols;
+    for (int a = 0; a < NB_ATTRIBUTES; ++a) {
+        attrs.push_back((Attribute)a);
+        cols.push_back(dataset.getAttribute((Attribute)a));
+    }
+    std::vector<std::vector<double>> r = (method == "spearman")
+        ? StatInfer::spearmanMatrix(dataset, attrs)
+        : StatInfer::correlationMatrix(cols);
+
+    std::ostringstream oss;
+    oss << "Matrice de correlation (" << method << ") :\n";
+    oss << std::setw(11) << "";
+    for (Attribute a : attrs) oss << std::setw(11) << attributeName(a);
+    oss << '\n' << std::fixed << std::setprecision(4);
+    for (size_t i = 0; i < attrs.size(); ++i) {
+        oss << std::setw(11) << attributeName(attrs[i]);
+        for (size_t j = 0; j < attrs.size(); ++j) oss << std::setw(11) << r[i][j];
+        oss << '\n';
+    }
+    result = oss.str();
+}
+
+// ------------------------------------------------------------
+// Commande "threads" : nombre de threads des calculs parallèles
+// Usage : threads      (affiche)
+//         threads N    (0 = nombre de coeurs)
+// Les résultats ne dépendent pas de ce nombre (découpage fixe, voir Parallel).
+// ------------------------------------------------------------
+void handleThreadsCommand(const std::vector<std::string>& args, std::string& result) {
+    std::ostringstream oss;
+    if (args.size() == 2) {
+        int n = -1;
+        try { n = std::stoi(args[1]); } catch (...) {}
+        if (n < 0) {
+            result = "N doit etre positif ou nul.\n";
+            return;
+        }
+        ThreadPool::setGlobalSize((unsigned)n);
+    } else if (args.size() != 1) {
+        result = "Usage : threads [N]\n";
+        return;
+    }
+    oss << "Threads de calcul : " << ThreadPool::global().size() << '\n';
+    result = oss.str();
+}
+
+// ------------------------------------------------------------
+// Commande "select" : filtre + agrégats (+ groupement) en une requête
+// Usage : select agg(expr), ... [where predicat] [group by bucket(expr, k)]
+// ex : select mean(daily), count() where streams > 10000 and solo/streams > 0.7 group by bucket(streams, 10)
+// ------------------------------------------------------------
+void handleSelectCommand(const SpotifyDataset& dataset, const std::vector<std::string>& args, std::string& result) {
+    std::string text;
+    for (const std::string& t : args) text += (text.empty() ? "" : " ") + t;
+
+    Query query;
+    std::string error;
+    if (!query.compile(text, error)) {
+        result = "Requete invalide : " + error + "\n"
+                 "Usage : select agg(expr),... [where predicat] [group by bucket(expr,k)]\n"
+                 "  agg : count, sum, mean, min, max, variance, stddev\n"
+                 "  expr : attributs, nombres, + - * / ( ), abs sqrt log exp min max pow\n";
+        return;
+    }
+    Query::Result r = query.run(dataset);
+
+    std::ostringstream oss;
+    oss << "Requete : " << r.selected << " ligne(s) selectionnee(s) sur " << r.total << "\n";
+    size_t labelWidth = 8;
+    for (const Query::Group& g : r.groups) labelWidth = std::max(labelWidth, g.label.size() + 2);
+    std::vector<size_t> widths;
+    for (const std::string& c : r.columns) widths.push_back(std::max<size_t>(14, c.size() + 2));
+
+    oss << std::left << std::setw((int)labelWidth) << "groupe" << std::right;
+    for (size_t c = 0; c < r.columns.size(); ++c) oss << std::setw((int)widths[c]) << r.columns[c];
+    oss << '\n';
+    for (const Query::Group& g : r.groups) {
+        oss << std::left << std::setw((int)labelWidth) << g.label << std::right;
+        for (size_t c = 0; c < g.values.size(); ++c) {
+            if (std::isnan(g.values[c])) oss << std::setw((int)widths[c]) << "-";
+            else                         oss << std::setw((int)widths[c]) << g.values[c];
+        }
+        oss << '\n';
+    }
+    result = oss.str();
 }
 
 // ------------------------------------------------------------
@@ -227,31 +645,518 @@ void showMenu() {
     std::cout << "    ANALYSE SPOTIFY - DATA MINING C++   \n";
     std::cout << "========================================\n";
     std::cout << "Commandes disponibles :\n";
-    std::cout << " " << COLOR_BOLD << "desc [stat] [attribut]" << COLOR_RESET << COLOR_GREEN << "      (ex: desc mean streams; stats: mean/median/mode/min/max/variance/stddev/amplitude)\n";
+    std::cout << " " << COLOR_BOLD << "desc [stat] [attribut]" << COLOR_RESET << COLOR_GREEN << "      (ex: desc mean streams; stats: mean/median/mode/min/max/variance/stddev/amplitude/all/percentiles)\n";
+    std::cout << " " << COLOR_BOLD << "desc quantile p [attribut]" << COLOR_RESET << COLOR_GREEN << "  (ex: desc quantile 0.9 daily)\n";
+    std::cout << " " << COLOR_BOLD << "desc heavy K [attribut]" << COLOR_RESET << COLOR_GREEN << "     (valeurs frequentes approx., ex: desc heavy 5 daily)\n";
     std::cout << " " << COLOR_BOLD << "top N [attribut]" << COLOR_RESET << COLOR_GREEN << "            (ex: top 10 streams)\n";
     std::cout << " " << COLOR_BOLD << "top gapleadfeature N" << COLOR_RESET << COLOR_GREEN << "   (plus grand ecart lead/feature)\n";
+    std::cout << " " << COLOR_BOLD << "rank [attribut] [artiste]" << COLOR_RESET << COLOR_GREEN << "   (ex: rank daily Taylor Swift)\n";
     std::cout << " " << COLOR_BOLD << "repartition" << COLOR_RESET << COLOR_GREEN << "                (ratio solo/feature par artiste)\n";
     std::cout << " " << COLOR_BOLD << "repartition global" << COLOR_RESET << COLOR_GREEN << "         (ratio global)\n";
     std::cout << " " << COLOR_BOLD << "proba top N [attr]" << COLOR_RESET << COLOR_GREEN << "        (ex: proba top 10 streams, modele uniforme: n/N)\n";
     std::cout << " " << COLOR_BOLD << "proba solo70" << COLOR_RESET << COLOR_GREEN << "               (proba >70% solo)\n";
     std::cout << " " << COLOR_BOLD << "proba condtop10daily seuil" << COLOR_RESET << COLOR_GREEN << "\n";
     std::cout << " " << COLOR_BOLD << "regression X Y [plot]" << COLOR_RESET << COLOR_GREEN << "             (ex: regression streams solo)\n";
+    std::cout << " " << COLOR_BOLD << "regression Y X1 X2 ..." << COLOR_RESET << COLOR_GREEN << "     (multiple, ex: regression daily streams aslead solo asfeature)\n";
     std::cout << " " << COLOR_BOLD << "correlation X Y" << COLOR_RESET << COLOR_GREEN << "           (ex: correlation solo asfeature)\n";
+    std::cout << "  (attribut ou expression sans espace pour desc/top/regression/correlation,\n"
+                 "   ex: top 10 abs(aslead-asfeature) ; desc mean log(streams) ; correlation solo/streams daily)\n";
+    std::cout << " " << COLOR_BOLD << "correlation matrix [spearman]" << COLOR_RESET << COLOR_GREEN << " (toutes les paires)\n";
     std::cout << " " << COLOR_BOLD << "ic mean [attribut]" << COLOR_RESET << COLOR_GREEN << "             (IC sur la moyenne)\n";
+    std::cout << " " << COLOR_BOLD << "ic boot [stat] [attribut(s)] [B]" << COLOR_RESET << COLOR_GREEN << " (bootstrap: mean/median/pearson/slope, ex: ic boot median daily 2000)\n";
     std::cout << " " << COLOR_BOLD << "ic prop [attribut] [seuil]" << COLOR_RESET << COLOR_GREEN << "    (IC sur une proportion)\n";
     std::cout << " " << COLOR_BOLD << "test testprop [attribut] [seuil] [prop]" << COLOR_RESET << COLOR_GREEN << "  (z-test de proportion)\n";
     std::cout << " " << COLOR_BOLD << "test ttestsolofeature" << COLOR_RESET << COLOR_GREEN << "      (test de moyenne)\n";
-    std::cout << " " << COLOR_BOLD << "save" << COLOR_RESET << COLOR_GREEN << "                           (sauvegarder dernier affichage)\n";
+    std::cout << " " << COLOR_BOLD << "test perm [X Y] [N]" << COLOR_RESET << COLOR_GREEN << "        (test de permutation, ex: test perm solo asfeature 20000)\n";
+    std::cout << " " << COLOR_BOLD << "select agg(expr),... [where ...] [group by bucket(expr,k)]" << COLOR_RESET << COLOR_GREEN << "\n";
+    std::cout << "      (ex: select mean(daily), count() where solo/streams > 0.7 group by bucket(streams, 10))\n";
+    std::cout << " " << COLOR_BOLD << "threads [N]" << COLOR_RESET << COLOR_GREEN << "                  (threads de calcul, ex: threads 8)\n";
+    std::cout << " " << COLOR_BOLD << "cache [stats|clear]" << COLOR_RESET << COLOR_GREEN << "          (cache des resultats)\n";
+    std::cout << " " << COLOR_BOLD << "reload [fichier]" << COLOR_RESET << COLOR_GREEN << "             (recharge le CSV en arriere-plan)\n";
+    std::cout << " " << COLOR_BOLD << "append fichier" << COLOR_RESET << COLOR_GREEN << "               (ajoute / met a jour des artistes par nom)\n";
+    std::cout << " " << COLOR_BOLD << "save [fichier]" << COLOR_RESET << COLOR_GREEN << "                 (sauvegarder dernier affichage)\n";
     std::cout << " " << COLOR_BOLD << "exit | quit" << COLOR_RESET << COLOR_GREEN << "                  (quitter)\n";
     std::cout << "----------------------------------------" << COLOR_RESET << "\n";
 }
 
 // ------------------------------------------------------------
-// Point d'entrée
+// Mode flux : main --stream fichier.csv <commande>
+// Le CSV est lu ligne à ligne et chaque valeur passe dans un accumulateur
+// (OnlineStats) : la mémoire ne dépend pas du nombre de lignes.
+// Commandes disponibles : celles qui se calculent en un passage.
+//  - desc [mean|min|max|amplitude|variance|stddev|all] attribut
+//  - correlation X Y
+//  - regression X Y        (second passage pour les résidus)
+//  - test ttestsolofeature
 // ------------------------------------------------------------
-int main() {
-    SpotifyDataset data;
+bool handleStreamCommand(const std::string& file, const std::vector<std::string>& tokens, std::string& result) {
+    std::ostringstream oss;
+    auto openError = [&]() {
+        result = "Impossible d'ouvrir " + file + "\n";
+        return false;
+    };
 
+    if (tokens.size() == 3 && tokens[0] == "desc") {
+        const std::string& stat = tokens[1];
+        Attribute a;
+        if (!resolveAttribute(tokens[2], a, result)) return false;
+        Moments m;
+        if (!SpotifyDataset::streamCSV(file, [&](std::string_view, const double* v) { m.add(v[(int)a]); }, std::cerr))
+            return openError();
+        if (m.count() == 0) {
+            result = "Aucune donnee.\n";
+            return true;
+        }
+        const std::string& attr = tokens[2];
+        if (stat == "mean")
+            oss << "Moyenne de " << attr << ": " << m.mean() << '\n';
+        else if (stat == "min")
+            oss << "Minimum de " << attr << ": " << m.min() << '\n';
+        else if (stat == "max")
+            oss << "Maximum de " << attr << ": " << m.max() << '\n';
+        else if (stat == "amplitude")
+            oss << "Amplitude de " << attr << ": " << m.amplitude() << '\n';
+        else if (stat == "variance")
+            oss << "Variance de " << attr << ": " << m.variance() << '\n';
+        else if (stat == "stddev" || stat == "ecarttype")
+            oss << "Ecart-type de " << attr << ": " << m.stddev() << '\n';
+        else if (stat == "all") {
+            StatDesc::Summary s = StatDesc::fromMoments(m);
+            oss << "Resume de " << attr << " :\n"
+                << "  effectif  : " << s.count << '\n'
+                << "  somme     : " << s.sum << '\n'
+                << "  moyenne   : " << s.mean << '\n'
+                << "  variance  : " << s.variance() << '\n'
+                << "  ecart-type: " << s.stddev() << '\n'
+                << "  minimum   : " << s.min << '\n'
+                << "  maximum   : " << s.max << '\n'
+                << "  amplitude : " << s.amplitude() << '\n'
+                << "  asymetrie : " << s.skewness << '\n'
+                << "  kurtosis  : " << s.kurtosis << " (excès)\n";
+        }
+        else
+            oss << "Stat non disponible en flux (mean|min|max|amplitude|variance|stddev|all).\n";
+    }
+    else if (tokens.size() == 3 && (tokens[0] == "correlation" || tokens[0] == "regression")) {
+        Attribute ax, ay;
+        if (!resolveAttribute(tokens[1], ax, result) || !resolveAttribute(tokens[2], ay, result)) return false;
+        CoMoments c;
+        if (!SpotifyDataset::streamCSV(file, [&](std::string_view, const double* v) { c.add(v[(int)ax], v[(int)ay]); }, std::cerr))
+            return openError();
+        if (tokens[0] == "correlation") {
+            oss << "Correlation de Pearson entre " << tokens[1] << " et " << tokens[2] << " : " << c.pearson() << "\n";
+        } else {
+            double a = c.slope(), b = c.intercept();
+            // Les résidus dépendent de la droite : second passage sur le fichier
+            Moments resid;
+            if (!SpotifyDataset::streamCSV(file, [&](std::string_view, const double* v) {
+                    resid.add(v[(int)ay] - (a * v[(int)ax] + b));
+                }, std::cerr))
+                return openError();
+            if (resid.count() != c.count()) { // fichier modifié entre les deux passages
+                result = "Le fichier " + file + " a change pendant le calcul.\n";
+                return false;
+            }
+            oss << "Regression " << tokens[1] << " -> " << tokens[2] << "\n"
+                << "Y = " << a << " * X + " << b << " ; R^2 = " << c.r2() << "\n"
+                << "Residuals: mean=" << resid.mean() << ", std=" << resid.stddev()
+                << ", min=" << resid.min() << ", max=" << resid.max() << "\n";
+        }
+    }
+    else if (tokens.size() == 2 && tokens[0] == "test" && tokens[1] == "ttestsolofeature") {
+        TTestState t;
+        if (!SpotifyDataset::streamCSV(file, [&](std::string_view, const double* v) {
+                t.addFirst(v[(int)Attribute::Solo]);
+                t.addSecond(v[(int)Attribute::AsFeature]);
+            }, std::cerr))
+            return openError();
+        double tstat = t.welchT(), df = t.welchDf();
+        oss << "T-statistique pour comparaison des moyennes (solo vs feature) : " << tstat
+            << " (ddl Welch = " << df << ", p-value = " << StatInfer::pValueStudent(tstat, df) << ")\n";
+    }
+    else {
+        oss << "Commande non disponible en flux. Usage : --stream fichier.csv <commande>\n"
+            << "  desc [mean|min|max|amplitude|variance|stddev|all] attribut\n"
+            << "  correlation X Y | regression X Y | test ttestsolofeature\n";
+        result = oss.str();
+        return false;
+    }
+
+    result = oss.str();
+    return true;
+}
+
+// ------------------------------------------------------------
+// Cache des résultats : clé = commande normalisée, invalidé par la
+// génération du dataset (voir QueryCache)
+// ------------------------------------------------------------
+QueryCache resultCache;
+
+// Commandes en lecture seule dont le résultat ne dépend que du dataset
+bool isCacheable(const std::vector<std::string>& tokens) {
+    static const char* const readOnly[] = {
+        "desc", "top", "rank", "repartition", "proba", "regression", "correlation", "ic", "test",
+        "select"
+    };
+    for (const char* name : readOnly)
+        if (tokens[0] == name) return true;
+    return false;
+}
+
+// ------------------------------------------------------------
+// Commande "cache" : cache stats | cache clear
+// ------------------------------------------------------------
+void handleCacheCommand(const std::vector<std::string>& args, std::string& result) {
+    std::ostringstream oss;
+    if (args.size() == 2 && args[1] == "clear") {
+        resultCache.clear();
+        oss << "Cache vide.\n";
+    } else if (args.size() == 2 && args[1] == "stats") {
+        QueryCache::Stats st = resultCache.stats();
+        size_t total = st.hits + st.misses;
+        oss << "Cache : " << st.entries << "/" << st.capacity << " entrees, "
+            << st.hits << " hit(s), " << st.misses << " miss(es)";
+        if (total > 0) oss << " (taux de hit " << (100.0 * st.hits / total) << "%)";
+        oss << '\n';
+    } else {
+        oss << "Usage : cache [stats|clear]\n";
+    }
+    result = oss.str();
+}
+
+// ------------------------------------------------------------
+// Dispatcher : exécute une commande découpée et renvoie son texte
+// (rien n'est affiché ici)
+// ------------------------------------------------------------
+std::string dispatchCommand(const SpotifyDataset& data, const std::vector<std::string>& tokens) {
+    std::string result;
+    const std::string sub = (tokens.size() > 1) ? tokens[1] : "";
+
+    // --- Commande "desc" ---
+    if (tokens[0] == "desc") {
+        handleDescCommand(data, tokens, result);
+    }
+    // --- Commande "top" ---
+    else if(tokens[0]=="top") handleTopCommand(data, tokens, result);
+    // --- Commande "rank" ---
+    else if(tokens[0]=="rank") handleRankCommand(data, tokens, result);
+    // --- "repartition global" ---
+    else if(tokens[0]=="repartition" && tokens.size()>1 && tokens[1]=="global")
+    handleGlobalRepartitionCommand(data, tokens, result);
+    // --- "repartition" ---
+    else if(tokens[0]=="repartition")
+    handleRepartitionCommand(data, tokens, result);
+    // --- "proba top N attr" ---
+    else if (tokens[0] == "proba" && tokens.size() == 4 && tokens[1] == "top") {
+        int n = std::stoi(tokens[2]);
+        Attribute attr;
+        if (!resolveAttribute(tokens[3], attr, result)) return result;
+        double proba = StatInfer::probaTopN(data, n, attr);
+        std::ostringstream oss;
+        oss << "Proba d'etre dans le top " << n << " de " << tokens[3]
+        << " (modele uniforme n/N): " << proba << "\n"; 
+        result = oss.str();
+    } 
+    // --- "proba solo70" ---
+    else if (tokens[0] == "proba" && sub == "solo70") {
+        double proba = StatInfer::probaParSoloRatio(data, 0.70);
+        std::ostringstream oss;
+        oss << "Proba qu'un artiste ait >70% de streams solo: " << proba << "\n";
+        result = oss.str();
+    }
+    // --- "proba condtop10daily seuil" ---
+    else if (tokens[0] == "proba" && sub == "condtop10daily" && tokens.size() == 3) {
+        double seuil = std::stod(tokens[2]);
+        double proba = StatInfer::probaCondTopNdaily_given_highStreams(data, seuil, 10);
+        std::ostringstream oss;
+        oss << "Proba(d'etre dans le top10 daily GLOBAL | streams > " << seuil << ") = " << proba << "\n";
+        result = oss.str();
+    } 
+    // --- "regression Y X1 X2 ..." (plusieurs prédicteurs) ---
+    else if (tokens[0] == "regression" && tokens.size() >= 4 && tokens.back() != "plot")
+        handleMultiRegressionCommand(data, tokens, result);
+    // --- "regression X Y" (première occurrence) ---
+    else if (tokens[0] == "regression" && (tokens.size() == 3 || tokens.size() == 4)) {
+        ResolvedColumn rx, ry;
+        if (!resolveColumn(data, tokens[1], rx, result) || !resolveColumn(data, tokens[2], ry, result)) return result;
+        size_t dropped = keepFiniteRows({&rx, &ry});
+        ColumnView x = rx.view;
+        ColumnView y = ry.view;
+        double a, b, r2;
+        if (rx.isAttribute && ry.isAttribute)
+            StatInfer::regressionLineaire(data.aggregates(), (size_t)rx.attr, (size_t)ry.attr, a, b, r2);
+        else
+            StatInfer::regressionLineaire(x, y, a, b, r2);
+        // Résidus
+        std::vector<double> resid;
+        resid.reserve(x.size());
+        for (size_t i = 0; i < x.size() && i < y.size(); ++i)
+            resid.push_back(y[i] - (a * x[i] + b));
+
+        double rmean = StatDesc::mean(resid);
+        double rstd  = StatDesc::stddev(resid);
+        double rmin  = StatDesc::min(resid);
+        double rmax  = StatDesc::max(resid);
+
+        std::ostringstream oss;
+        if (dropped > 0) oss << "(" << dropped << " ligne(s) non definie(s) ignoree(s))\n";
+        oss << "Regression " << tokens[1] << " -> " << tokens[2] << "\n"
+            << "Y = " << a << " * X + " << b << " ; R^2 = " << r2 << "\n"
+            << "Residuals: mean=" << rmean << ", std=" << rstd
+            << ", min=" << rmin << ", max=" << rmax << "\n";
+        if (tokens.size() == 4 && tokens[3] == "plot")
+            StatInfer::regressionAsciiPlot(x, y, a, b, oss); // trace à la suite du résultat
+        result = oss.str();
+    }
+    // --- "correlation matrix [pearson|spearman]" ---
+    else if (tokens[0] == "correlation" && tokens.size() >= 2 && tokens[1] == "matrix")
+        handleCorrelationMatrixCommand(data, tokens, result);
+    // --- "correlation X Y" ---
+    else if (tokens[0] == "correlation" && tokens.size() == 3) {
+    ResolvedColumn rx, ry;
+    if (!resolveColumn(data, tokens[1], rx, result) || !resolveColumn(data, tokens[2], ry, result)) return result;
+    size_t dropped = keepFiniteRows({&rx, &ry});
+    double corr = (rx.isAttribute && ry.isAttribute)
+        ? data.aggregates().pearson((size_t)rx.attr, (size_t)ry.attr)
+        : StatInfer::pearson(rx.view, ry.view);
+    std::ostringstream oss;
+    if (dropped > 0) oss << "(" << dropped << " ligne(s) non definie(s) ignoree(s))\n";
+    oss << "Correlation de Pearson entre " << tokens[1] << " et " << tokens[2] << " : " << corr << "\n";
+    result = oss.str();
+    }
+    // --- "test ttestsolofeature" ---
+    else if (tokens[0] == "test" && sub == "ttestsolofeature") {
+    auto solo = data.getAttribute(Attribute::Solo);
+    auto feat = data.getAttribute(Attribute::AsFeature);
+    StatInfer::WelchTest w = StatInfer::welchTest(solo, feat);
+    std::ostringstream oss;
+    oss << "T-statistique pour comparaison des moyennes (solo vs feature) : " << w.t
+    << " (ddl Welch = " << w.df << ", p-value = " << w.pValue << ")\n";
+    result = oss.str();
+    }
+    // --- "ic mean attr" ---
+    else if (tokens[0] == "ic" && sub == "mean")
+        handleICMeanCommand(data, tokens, result);
+
+    // --- "ic boot stat attr... [B] [alpha]" ---
+    else if (tokens[0] == "ic" && sub == "boot")
+        handleICBootCommand(data, tokens, result);
+
+    // --- "ic prop attr seuil" ---
+    else if (tokens[0] == "ic" && sub == "prop")
+        handleICPropCommand(data, tokens, result);
+
+    // --- "test perm [X Y] [N] [alpha]" ---
+    else if (tokens[0] == "test" && sub == "perm")
+        handlePermTestCommand(data, tokens, result);
+
+    // --- "test testprop attr seuil p0" ---
+    else if (tokens[0] == "test" && sub == "testprop")
+        handleTestPropCommand(data, tokens, result);
+
+    // --- "select ... [where ...] [group by ...]" ---
+    else if (tokens[0] == "select")
+        handleSelectCommand(data, tokens, result);
+
+    // --- "threads [N]" ---
+    else if (tokens[0] == "threads")
+        handleThreadsCommand(tokens, result);
+    // --- "cache stats|clear" ---
+    else if (tokens[0] == "cache")
+        handleCacheCommand(tokens, result);
+    else
+        result = "Commande inconnue.\n";
+    return result;
+}
+
+// Exécute une ligne de commande : résultat en cache si la même commande a déjà été
+// calculée sur la même génération du dataset, sinon calcul puis mise en cache.
+std::string executeCommand(const SpotifyDataset& data, const std::string& command) {
+    std::vector<std::string> tokens = split(command);
+    if (tokens.empty()) return "";
+
+    bool cacheable = isCacheable(tokens);
+    std::string key, result;
+    if (cacheable) {
+        for (const std::string& t : tokens) key += (key.empty() ? "" : " ") + t;
+        if (resultCache.get(key, data.generation(), result)) return result;
+    }
+    try {
+        result = dispatchCommand(data, tokens);
+    } catch (const std::exception&) {
+        // stoi/stod sur un argument non numérique
+        return "Argument invalide : " + command + "\n";
+    }
+    if (cacheable) resultCache.put(key, data.generation(), result);
+    return result;
+}
+
+// "threads N" remplace le pool global, qu'un rechargement en arrière-plan
+// (reload, --watch) peut être en train d'utiliser : jamais les deux à la fois.
+std::string executeThreadsCommand(DatasetHolder& datasets, const std::string& command) {
+    std::string result;
+    if (!datasets.runExclusive([&]() { result = executeCommand(*datasets.current(), command); }))
+        result = "Rechargement en cours : relancez 'threads' une fois termine.\n";
+    return result;
+}
+
+// ------------------------------------------------------------
+// Mode batch : main -f requetes.txt  (ou requêtes sur stdin redirigé)
+// Une commande par ligne, lignes vides et '#' ignorés, 'exit' arrête.
+// Pas de menu. Les commandes en lecture seule consécutives forment un groupe
+// exécuté sur 'jobs' threads, toutes sur la même version du dataset ;
+// threads / cache / save / reload / append sont des barrières
+// exécutées seules, dans l'ordre. Les résultats sont écrits dans l'ordre du
+// script : sur stdout ("> commande" puis le résultat) ou, avec outDir, un
+// fichier par commande (0001.txt, 0002.txt, ...).
+// ------------------------------------------------------------
+int runBatch(DatasetHolder& datasets, std::istream& in, unsigned jobs, const std::string& outDir) {
+    std::vector<std::string> commands;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::vector<std::string> tokens = split(line);
+        if (tokens.empty() || tokens[0][0] == '#') continue;
+        if (tokens[0] == "exit" || tokens[0] == "quit") break;
+        commands.push_back(line);
+    }
+
+    if (!outDir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(outDir, ec);
+        if (ec) {
+            std::cout << "Impossible de creer le dossier " << outDir << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<std::string> results(commands.size());
+    auto isBarrier = [&](size_t i) {
+        std::vector<std::string> tokens = split(commands[i]);
+        return !isCacheable(tokens);
+    };
+    auto emit = [&](size_t i) {
+        lastResult = results[i];
+        if (outDir.empty()) {
+            std::cout << "> " << commands[i] << '\n' << results[i];
+            return;
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "%04zu.txt", i + 1);
+        std::ofstream out(std::filesystem::path(outDir) / name);
+        out << results[i];
+    };
+
+    std::unique_ptr<ThreadPool> pool;
+    if (jobs > 1) pool.reset(new ThreadPool(jobs));
+
+    size_t i = 0;
+    while (i < commands.size()) {
+        if (isBarrier(i)) {
+            std::vector<std::string> tokens = split(commands[i]);
+            if (tokens[0] == "save")
+                results[i] = (tokens.size() == 2) ? saveToFile(tokens[1], lastResult) : "Usage : save fichier\n";
+            else if (tokens[0] == "reload")
+                datasets.reload(tokens.size() >= 2 ? tokens[1] : "", results[i]);
+            else if (tokens[0] == "append" && tokens.size() == 2)
+                datasets.upsert(tokens[1], results[i]);
+            else if (tokens[0] == "threads")
+                results[i] = executeThreadsCommand(datasets, commands[i]);
+            else
+                results[i] = executeCommand(*datasets.current(), commands[i]);
+            emit(i++);
+            continue;
+        }
+        size_t end = i;
+        while (end < commands.size() && !isBarrier(end)) end++;
+        DatasetHolder::Snapshot data = datasets.current();
+        auto run = [&](size_t k) { results[i + k] = executeCommand(*data, commands[i + k]); };
+        if (pool) pool->parallelFor(end - i, run);
+        else for (size_t k = 0; k < end - i; ++k) run(k);
+        while (i < end) emit(i++);
+    }
+
+    if (!outDir.empty())
+        std::cout << commands.size() << " commande(s) executee(s), resultats dans " << outDir << "\n";
+    return 0;
+}
+
+// ------------------------------------------------------------
+// Mode serveur : main --serve unix:/chemin | tcp:PORT  [-j N]
+// Chaque ligne reçue est une commande ; seules les commandes en lecture seule,
+// "cache stats" et "reload" (sans argument : source d'origine) sont acceptées.
+// Chaque requête travaille sur la version du dataset publiée à son arrivée.
+// ------------------------------------------------------------
+int runServer(DatasetHolder& datasets, const std::string& address, unsigned jobs) {
+    QueryServer server([&datasets](const std::string& command) -> std::string {
+        std::vector<std::string> tokens = split(command);
+        if (tokens.empty()) return "";
+        if (tokens.size() == 1 && tokens[0] == "reload") {
+            std::string message;
+            datasets.reload("", message);
+            return message;
+        }
+        bool allowed = isCacheable(tokens)
+            || (tokens[0] == "cache" && tokens.size() == 2 && tokens[1] == "stats");
+        if (!allowed) return "Commande refusee par le serveur : " + command + "\n";
+        return executeCommand(*datasets.current(), command);
+    }, jobs);
+
+    std::string error;
+    bool ok;
+    if (address.rfind("unix:", 0) == 0) {
+        ok = server.listenUnix(address.substr(5), error);
+    } else if (address.rfind("tcp:", 0) == 0) {
+        int port = 0;
+        try { port = std::stoi(address.substr(4)); } catch (const std::exception&) {}
+        if (port <= 0 || port > 65535) {
+            std::cout << "Port invalide : " << address << "\n";
+            return 1;
+        }
+        ok = server.listenTcp((uint16_t)port, error);
+    } else {
+        std::cout << "Adresse invalide : " << address << " (unix:/chemin ou tcp:PORT)\n";
+        return 1;
+    }
+    if (!ok) {
+        std::cout << "Impossible d'ecouter sur " << address << " : " << error << "\n";
+        return 1;
+    }
+    std::cout << "Serveur en ecoute sur " << address << " (" << datasets.current()->size() << " artistes)\n" << std::flush;
+    server.run();
+    return 0;
+}
+
+// ------------------------------------------------------------
+// Options de la ligne de commande
+// ------------------------------------------------------------
+const unsigned MAX_THREADS = 1024;
+
+// Nombre de threads ou de workers : entier de 1 à MAX_THREADS, sans autre caractère
+bool parseCount(const char* text, unsigned& value) {
+    const char* end = text + std::char_traits<char>::length(text);
+    unsigned v = 0;
+    auto [ptr, ec] = std::from_chars(text, end, v);
+    if (ec != std::errc() || ptr != end || v < 1 || v > MAX_THREADS) return false;
+    value = v;
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage : " << program << " [options] [--stream fichier.csv commande...]\n"
+              << "  --threads N     taille du pool de calcul (1 a " << MAX_THREADS << ")\n"
+              << "  -f fichier      mode batch sur un script de commandes\n"
+              << "  -j N            commandes en parallele en batch, workers en serveur (1 a " << MAX_THREADS << ")\n"
+              << "  -o dossier      mode batch : un fichier de resultat par commande\n"
+              << "  --interactive   menu interactif meme si stdin est redirige\n"
+              << "  --serve ADR     serveur de requetes (unix:/chemin ou tcp:PORT)\n"
+              << "  --watch         recharge le dataset des que artists.csv est modifie\n";
+}
+
+// ------------------------------------------------------------
+// Point d'entrée
+// ------------------------------------------------------------
+int main(int argc, char* argv[]) {
     // Ouvre un fichier de log et rediriger std::cerr
     std::ofstream logStream("logs", std::ios::out | std::ios::trunc);
     std::streambuf* oldCerrBuf = nullptr;
@@ -261,9 +1166,49 @@ int main() {
     std::cerr << "Impossible d'ouvrir le fichier de logs.\n";
     }
 
-    // Chargement du CSV (les messages d'import iront dans 'logs')
-    if (!data.loadFromCSV("artists.csv")) {
-    std::cerr << "Erreur lors de l'ouverture du CSV\n";
+    // Options :
+    //   --threads N     taille du pool utilisé par les calculs parallèles
+    //   -f fichier      mode batch sur un script de commandes
+    //   -j N            mode batch : N commandes indépendantes en parallèle
+    //   -o dossier      mode batch : un fichier de résultat par commande
+    //   --interactive   menu interactif même si stdin est redirigé
+    //   --serve ADR     serveur de requêtes (unix:/chemin ou tcp:PORT) ; -j = workers
+    //                   (par défaut un par coeur) ; Linux uniquement (MakeFile.sh)
+    //   --watch         recharge le dataset dès que artists.csv est modifié
+    int argi = 1;
+    std::string scriptFile, outDir, serveAddress;
+    unsigned jobs = 0; // défaut : 1 en batch, un worker par coeur en serveur
+    bool forceInteractive = false, watch = false;
+    while (argi < argc) {
+        std::string opt = argv[argi];
+        bool hasValue = (argi + 1 < argc);
+        if ((opt == "--threads" || opt == "-j") && hasValue) {
+            unsigned n = 0;
+            if (!parseCount(argv[++argi], n)) {
+                if (oldCerrBuf) std::cerr.rdbuf(oldCerrBuf);
+                std::cout << "Valeur invalide pour " << opt << " : " << argv[argi] << "\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            if (opt == "-j") jobs = n;
+            else ThreadPool::setGlobalSize(n);
+        }
+        else if (opt == "-f" && hasValue) scriptFile = argv[++argi];
+        else if (opt == "-o" && hasValue) outDir = argv[++argi];
+        else if (opt == "--interactive") forceInteractive = true;
+        else if (opt == "--serve" && hasValue) serveAddress = argv[++argi];
+        else if (opt == "--watch") watch = true;
+        else break; // --stream ou argument inconnu
+        argi++;
+    }
+
+    // Mode flux : une commande sur un CSV lu sans le charger, puis sortie
+    if (argc >= argi + 2 && std::string(argv[argi]) == "--stream") {
+        std::vector<std::string> tokens(argv + argi + 2, argv + argc);
+        bool ok = handleStreamCommand(argv[argi + 1], tokens, lastResult);
+        std::cout << lastResult;
+        if (oldCerrBuf) std::cerr.rdbuf(oldCerrBuf);
+        return ok ? 0 : 1;
     }
 
     // Restaurer std::cerr
@@ -272,11 +1217,33 @@ int main() {
     logStream.close();
     }
 
+    // Chargement (snapshot binaire à jour, sinon CSV ; les messages iront dans 'logs')
+    DatasetHolder datasets("artists.csv", "logs");
+    std::string loadMessage;
+    datasets.reload("", loadMessage);
+    if (watch) datasets.startWatch(std::chrono::seconds(2));
+
+    if (!serveAddress.empty())
+        return runServer(datasets, serveAddress, jobs);
+
+    // Mode batch : script (-f) ou stdin redirigé
+    if (!scriptFile.empty()) {
+        std::ifstream script(scriptFile);
+        if (!script) {
+            std::cout << "Impossible d'ouvrir " << scriptFile << "\n";
+            return 1;
+        }
+        return runBatch(datasets, script, jobs, outDir);
+    }
+    if (!forceInteractive && !isatty(fileno(stdin)))
+        return runBatch(datasets, std::cin, jobs, outDir);
+
     std::string command;
     while (true) {
         showMenu();
+        std::cout << datasets.takeNotices(); // rechargements terminés en arrière-plan
         std::cout << "\nCommande (ou 'exit' pour quitter) : ";
-        std::getline(std::cin, command);
+        if (!std::getline(std::cin, command)) break;
 
         if (command == "exit" || command == "quit") {
             break;
@@ -285,119 +1252,39 @@ int main() {
 
         if (tokens.empty()) continue;
 
-        // --- Commande "desc" ---
-        if (tokens[0] == "desc") {
-            handleDescCommand(data, tokens, lastResult);
+        // --- "save [fichier]" : sauvegarde lastResult dans un fichier ---
+        if (tokens[0]=="save") {
+        std::string filename;
+        if (tokens.size() == 2) filename = tokens[1];
+        else { std::cout << "Nom du fichier de sortie ? "; std::getline(std::cin, filename); }
+        std::cout << saveToFile(filename, lastResult);
+        continue;
         }
-        // --- Commande "top" ---
-        else if(tokens[0]=="top") handleTopCommand(data, tokens, lastResult);
-        // --- "repartition global" ---
-        else if(tokens[0]=="repartition" && tokens.size()>1 && tokens[1]=="global")
-        handleGlobalRepartitionCommand(data, tokens, lastResult);
-        // --- "repartition" ---
-        else if(tokens[0]=="repartition")
-        handleRepartitionCommand(data, tokens, lastResult);
-        // --- "proba top N attr" ---
-        else if (tokens[0] == "proba" && tokens.size() == 4 && tokens[1] == "top") {
-            int n = std::stoi(tokens[2]);
-            double proba = StatInfer::probaTopN(data.getArtists(), n, tokens[3]);
-            std::ostringstream oss;
-            oss << "Proba d'etre dans le top " << n << " de " << tokens[3]
-            << " (modele uniforme n/N): " << proba << "\n"; 
-            lastResult = oss.str();
-            std::cout << lastResult;
-        } 
-        // --- "proba solo70" ---
-        else if (tokens[0] == "proba" && tokens[1] == "solo70") {
-            double proba = StatInfer::probaParSoloRatio(data.getArtists(), 0.70);
-            std::ostringstream oss;
-            oss << "Proba qu'un artiste ait >70% de streams solo: " << proba << "\n";
-            lastResult = oss.str();
-            std::cout << lastResult;
+
+        // --- "reload [fichier]" : rechargement en arrière-plan, les requêtes continuent ---
+        if (tokens[0] == "reload") {
+            std::string file = (tokens.size() >= 2) ? tokens[1] : datasets.source();
+            if (datasets.reloadAsync(file)) std::cout << "Rechargement de " << file << " lance en arriere-plan.\n";
+            else std::cout << "Rechargement deja en cours.\n";
+            continue;
         }
-        // --- "proba condtop10daily seuil" ---
-        else if (tokens[0] == "proba" && tokens[1] == "condtop10daily" && tokens.size() == 3) {
-            double seuil = std::stod(tokens[2]);
-            double proba = StatInfer::probaCondTopNdaily_given_highStreams(data.getArtists(), seuil, 10);
-            std::ostringstream oss;
-            oss << "Proba(d'etre dans le top10 daily GLOBAL | streams > " << seuil << ") = " << proba << "\n";
-            lastResult = oss.str();
-            std::cout << lastResult;
-        } 
-        // --- "regression X Y" (première occurrence) ---
-        else if (tokens[0] == "regression" && (tokens.size() == 3 || tokens.size() == 4)) {
-            auto x = data.getAttribute(tokens[1]);
-            auto y = data.getAttribute(tokens[2]);
-            double a, b, r2;
-            StatInfer::regressionLineaire(x, y, a, b, r2);
-            // Résidus
-            std::vector<double> resid;
-            resid.reserve(x.size());
-            for (size_t i = 0; i < x.size() && i < y.size(); ++i)
-                resid.push_back(y[i] - (a * x[i] + b));
-
-            double rmean = StatDesc::mean(resid);
-            double rstd  = StatDesc::stddev(resid);
-            double rmin  = resid.empty() ? 0.0 : *std::min(resid.begin(), resid.end());
-            double rmax  = resid.empty() ? 0.0 : *std::max(resid.begin(), resid.end());
-
-            std::ostringstream oss;
-            oss << "Regression " << tokens[1] << " -> " << tokens[2] << "\n"
-                << "Y = " << a << " * X + " << b << " ; R^2 = " << r2 << "\n"
-                << "Residuals: mean=" << rmean << ", std=" << rstd
-                << ", min=" << rmin << ", max=" << rmax << "\n";
-            if (tokens.size() == 4 && tokens[3] == "plot") {
-                oss << "(Graphe ASCII affiche)\n";
-            }
-            lastResult = oss.str();
-            std::cout << lastResult;
 
-            if (tokens.size() == 4 && tokens[3] == "plot") {
-                StatInfer::regressionAsciiPlot(x, y, a, b); // trace sur stdout
-            }
+        // --- "append fichier" : ajout / mise à jour par nom d'artiste ---
+        if (tokens[0] == "append" && tokens.size() == 2) {
+            datasets.upsert(tokens[1], lastResult);
+            std::cout << lastResult;
+            continue;
         }
-        // --- "correlation X Y" ---
-        else if (tokens[0] == "correlation" && tokens.size() == 3) {
-        auto x = data.getAttribute(tokens[1]);
-        auto y = data.getAttribute(tokens[2]);
-        double corr = StatInfer::pearson(x, y);
-        std::ostringstream oss;
-        oss << "Correlation de Pearson entre " << tokens[1] << " et " << tokens[2] << " : " << corr << "\n";
-        lastResult = oss.str();
-        std::cout << lastResult;
+
+        // --- "threads [N]" : pas pendant un rechargement en arrière-plan ---
+        if (tokens[0] == "threads") {
+            lastResult = executeThreadsCommand(datasets, command);
+            std::cout << lastResult;
+            continue;
         }
-        // --- "test ttestsolofeature" ---
-        else if (tokens[0] == "test" && tokens[1] == "ttestsolofeature") {
-        auto solo = data.getAttribute("solo");
-        auto feat = data.getAttribute("asfeature");
-        double tstat = StatInfer::ttest2moyennes(solo, feat);
-        std::ostringstream oss;
-        oss << "T-statistique pour comparaison des moyennes (solo vs feature) : " << tstat
-        << " (|t| >= ~2 => significatif a 5% environ)\n";
-        lastResult = oss.str();
+
+        lastResult = executeCommand(*datasets.current(), command);
         std::cout << lastResult;
-        }
-        // --- "ic mean attr" ---
-        else if (tokens[0] == "ic" && tokens[1] == "mean")
-            handleICMeanCommand(data, tokens, lastResult);
-
-        // --- "ic prop attr seuil" ---
-        else if (tokens[0] == "ic" && tokens[1] == "prop")
-            handleICPropCommand(data, tokens, lastResult);
-
-        // --- "test testprop attr seuil p0" ---
-        else if (tokens[0] == "test" && tokens[1] == "testprop")
-            handleTestPropCommand(data, tokens, lastResult);
-
-        // --- "save" : sauvegarde lastResult dans un fichier ---
-        else if (tokens[0]=="save") {
-        std::cout << "Nom du fichier de sortie ? ";
-        std::string filename; std::getline(std::cin, filename);
-        saveToFile(filename, lastResult);
-        }
-        else {
-            std::cout << "Commande inconnue.\n";
-        }
     }
     return 0;
 }
@@ -0,0 +1,27 @@
+#pragma once
+#include <iostream>
+#include <cmath>
+
+// Assertions des tests : un échec est affiché puis compté, le test continue.
+// Le programme de test renvoie checkFailures() != 0.
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::cerr << __FILE__ << ":" << __LINE__ << " : echec " #cond "\n"; checkFailures()++; } } while (0)
+
+// |a - b| <= tol * max(1, |a|, |b|)
+#define CHECK_CLOSE(a, b, tol) \
+    do { double ca_ = (a), cb_ = (b); \
+         double sc_ = std::fmax(1.0, std::fmax(std::fabs(ca_), std::fabs(cb_))); \
+         if (!(std::fabs(ca_ - cb_) <= (tol) * sc_)) { \
+             std::cerr << __FILE__ << ":" << __LINE__ << " : echec " #a " ~ " #b " (" << ca_ << " vs " << cb_ << ")\n"; \
+             checkFailures()++; } } while (0)
+
+inline int testResult(const char* name) {
+    if (checkFailures() == 0) std::cout << name << " : OK\n";
+    else std::cout << name << " : " << checkFailures() << " echec(s)\n";
+    return checkFailures() == 0 ? 0 : 1;
+}
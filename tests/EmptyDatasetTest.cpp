@@ -0,0 +1,48 @@
+// Dataset vide (CSV réduit à l'en-tête) : les statistiques renvoient 0 au lieu
+// de lire hors des colonnes.
+#include "../src/SpotifyDataset.h"
+#include "../src/StatDesc.h"
+#include "../src/StatInfer.h"
+#include "../src/Parallel.h"
+#include "Check.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+
+int main() {
+    // --- Colonne vide ---
+    std::vector<double> none;
+    CHECK(StatDesc::min(none) == 0.0);
+    CHECK(StatDesc::max(none) == 0.0);
+    CHECK(StatDesc::amplitude(none) == 0.0);
+    double mn = 1.0, mx = 1.0;
+    Parallel::minMax(none.data(), 0, mn, mx);
+    CHECK(mn == 0.0 && mx == 0.0);
+
+    // --- CSV sans ligne de données ---
+    const char* file = "empty_dataset_test.csv";
+    {
+        std::ofstream out(file);
+        out << "Artist,Streams,Daily,As lead,Solo,As feature\n";
+    }
+    SpotifyDataset data;
+    std::ostringstream log;
+    CHECK(data.loadFromCSV(file, log));
+    std::remove(file);
+    CHECK(data.size() == 0);
+
+    // Chemin de "regression streams daily" : droite puis résumé des résidus
+    ColumnView x = data.getAttribute(Attribute::Streams);
+    ColumnView y = data.getAttribute(Attribute::Daily);
+    double a = 1.0, b = 1.0, r2 = 1.0;
+    StatInfer::regressionLineaire(data.aggregates(), (size_t)Attribute::Streams, (size_t)Attribute::Daily, a, b, r2);
+    std::vector<double> resid;
+    for (size_t i = 0; i < x.size() && i < y.size(); ++i) resid.push_back(y[i] - (a * x[i] + b));
+    CHECK(StatDesc::min(resid) == 0.0);
+    CHECK(StatDesc::max(resid) == 0.0);
+    CHECK(StatDesc::min(x) == 0.0);
+    CHECK(StatDesc::amplitude(y) == 0.0);
+
+    return testResult("EmptyDatasetTest");
+}
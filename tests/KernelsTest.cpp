@@ -0,0 +1,77 @@
+// Noyaux de réduction : chaque jeu d'instructions disponible est comparé à une
+// boucle séquentielle (écart relatif < 1e-13, min/max exacts), comme annoncé
+// dans Kernels.h.
+#include "../src/Kernels.h"
+#include "Check.h"
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Générateur déterministe : valeurs positives étalées comme les streams Spotify
+struct Lcg {
+    uint64_t s = 0x9E3779B97F4A7C15ull;
+    double next() {
+        s = s * 6364136223846793005ull + 1442695040888963407ull;
+        return (double)(s >> 11) / (double)(1ull << 53);
+    }
+};
+
+double seqSum(const std::vector<double>& x) {
+    double s = 0.0;
+    for (double v : x) s += v;
+    return s;
+}
+
+void checkIsa(Kernels::Isa isa, const std::vector<double>& x, const std::vector<double>& y) {
+    Kernels::setIsa(isa);
+    if (Kernels::isa() != isa) return;      // non supporté par ce processeur
+    size_t n = x.size();
+
+    double sx = seqSum(x), sy = seqSum(y);
+    CHECK_CLOSE(Kernels::sum(x.data(), n), sx, 1e-13);
+
+    double mx = n ? sx / n : 0.0, my = n ? sy / n : 0.0;
+    double sxx = 0.0, syy = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double dx = x[i] - mx, dy = y[i] - my;
+        sxx += dx * dx; syy += dy * dy; sxy += dx * dy;
+    }
+    CHECK_CLOSE(Kernels::sumSqDev(x.data(), n, mx), sxx, 1e-13);
+
+    Kernels::CrossDev c = Kernels::crossDev(x.data(), y.data(), n, mx, my);
+    CHECK_CLOSE(c.sxx, sxx, 1e-13);
+    CHECK_CLOSE(c.syy, syy, 1e-13);
+    // Σ(x-mx)(y-my) peut être proche de 0 : écart rapporté à sqrt(Sxx·Syy)
+    CHECK(std::fabs(c.sxy - sxy) <= 1e-13 * std::fmax(1.0, std::sqrt(sxx * syy)));
+
+    if (n > 0) {
+        double lo = x[0], hi = x[0];
+        for (double v : x) { if (v < lo) lo = v; if (v > hi) hi = v; }
+        double mn = 0.0, mxv = 0.0;
+        Kernels::minMax(x.data(), n, mn, mxv);
+        CHECK(mn == lo && mxv == hi);
+    }
+}
+
+} // namespace
+
+int main() {
+    Lcg rng;
+    const size_t sizes[] = { 0, 1, 7, 33, 1000, 100003 };
+    for (size_t n : sizes) {
+        std::vector<double> x(n), y(n);
+        for (size_t i = 0; i < n; ++i) {
+            double u = rng.next();
+            x[i] = 1e5 + u * u * 4e9;                   // streams
+            y[i] = x[i] / 1500.0 + rng.next() * 2e5;    // daily, corrélé
+        }
+        // Extrema placés en fin de tableau pour passer par la boucle de reste
+        if (n > 2) { x[n - 1] = 5e9; x[n - 2] = 1.0; }
+
+        checkIsa(Kernels::Isa::Scalar, x, y);
+        checkIsa(Kernels::Isa::Avx2, x, y);
+        checkIsa(Kernels::Isa::Avx512, x, y);
+    }
+    return testResult("KernelsTest");
+}
@@ -0,0 +1,235 @@
+// Query::run comparé à une boucle naïve ligne par ligne sur un dataset construit à
+// la main : parenthèses (retour arrière de parseNot), comparaisons avec NaN et ±inf,
+// bornes des classes de bucket() et clés de groupe non finies.
+#include "../src/SpotifyDataset.h"
+#include "../src/Query.h"
+#include "Check.h"
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace {
+
+const char* CSV = "query_test.csv";
+
+struct Row {
+    double streams, daily, aslead, solo, asfeature;
+};
+using Fn = std::function<double(const Row&)>;
+using Pred = std::function<bool(const Row&)>;
+
+struct NaiveAgg {
+    Query::AggKind kind;
+    Fn f; // vide pour count()
+};
+
+// Résultat attendu, calculé ligne par ligne avec les règles documentées dans Query.h
+Query::Result naive(const std::vector<Row>& rows, const Pred& pred, const std::vector<NaiveAgg>& aggs,
+                    const Fn& key = Fn(), size_t k = 0) {
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    Query::Result res;
+    res.total = rows.size();
+    std::vector<const Row*> sel;
+    for (const Row& r : rows)
+        if (!pred || pred(r)) sel.push_back(&r);
+    res.selected = sel.size();
+
+    size_t nbGroups = 1;
+    double mn = 0, mx = 0, width = 0;
+    if (key) {
+        bool any = false;
+        for (const Row* r : sel) {
+            double v = key(*r);
+            if (!std::isfinite(v)) continue;
+            if (!any || v < mn) mn = v;
+            if (!any || v > mx) mx = v;
+            any = true;
+        }
+        nbGroups = any ? k : 0;
+        width = any ? (mx - mn) / (double)k : 0.0;
+    }
+
+    std::vector<std::vector<const Row*>> members(nbGroups);
+    for (const Row* r : sel) {
+        size_t g = 0;
+        if (key) {
+            double v = key(*r);
+            if (!std::isfinite(v)) continue;        // hors de tout groupe
+            g = (width > 0) ? (size_t)((v - mn) / width) : 0;
+            if (g >= nbGroups) g = nbGroups - 1;    // le max est dans la dernière classe
+        }
+        members[g].push_back(r);
+    }
+
+    for (size_t g = 0; g < nbGroups; ++g) {
+        Query::Group grp;
+        grp.rows = members[g].size();
+        for (const NaiveAgg& a : aggs) {
+            if (a.kind == Query::AggKind::Count) { grp.values.push_back((double)grp.rows); continue; }
+            std::vector<double> v;
+            for (const Row* r : members[g]) {
+                double x = a.f(*r);
+                if (std::isfinite(x)) v.push_back(x);
+            }
+            double sum = 0, lo = NaN, hi = NaN;
+            for (double x : v) {
+                sum += x;
+                if (!(x >= lo)) lo = x;
+                if (!(x <= hi)) hi = x;
+            }
+            double mean = v.empty() ? NaN : sum / (double)v.size();
+            double ss = 0;
+            for (double x : v) ss += (x - mean) * (x - mean);
+            double var = (v.size() < 2) ? NaN : ss / (double)(v.size() - 1);
+            switch (a.kind) {
+                case Query::AggKind::Count:    break;
+                case Query::AggKind::Sum:      grp.values.push_back(sum); break;
+                case Query::AggKind::Mean:     grp.values.push_back(mean); break;
+                case Query::AggKind::Min:      grp.values.push_back(lo); break;
+                case Query::AggKind::Max:      grp.values.push_back(hi); break;
+                case Query::AggKind::Variance: grp.values.push_back(var); break;
+                case Query::AggKind::Stddev:   grp.values.push_back(std::sqrt(var)); break;
+            }
+        }
+        res.groups.push_back(grp);
+    }
+    return res;
+}
+
+Query::Result runQuery(const SpotifyDataset& data, const std::string& text) {
+    Query q;
+    std::string error;
+    bool ok = q.compile(text, error);
+    if (!ok) std::cerr << "requete refusee : " << text << " : " << error << "\n";
+    CHECK(ok);
+    return ok ? q.run(data) : Query::Result();
+}
+
+void compare(const Query::Result& got, const Query::Result& want, const std::string& text) {
+    size_t before = checkFailures();
+    CHECK(got.total == want.total);
+    CHECK(got.selected == want.selected);
+    CHECK(got.groups.size() == want.groups.size());
+    for (size_t g = 0; g < got.groups.size() && g < want.groups.size(); ++g) {
+        const Query::Group& a = got.groups[g];
+        const Query::Group& b = want.groups[g];
+        CHECK(a.rows == b.rows);
+        CHECK(a.values.size() == b.values.size());
+        for (size_t i = 0; i < a.values.size() && i < b.values.size(); ++i) {
+            if (std::isnan(b.values[i])) CHECK(std::isnan(a.values[i]));
+            else CHECK_CLOSE(a.values[i], b.values[i], 1e-9);
+        }
+    }
+    if ((size_t)checkFailures() != before) std::cerr << "  dans : " << text << "\n";
+}
+
+} // namespace
+
+int main() {
+    // 70000 lignes : plusieurs lots de Expression::BATCH et deux morceaux de Parallel::CHUNK.
+    // streams == 0 une ligne sur 11 : solo/streams vaut +inf, ou NaN quand solo == 0 aussi.
+    {
+        std::ofstream out(CSV);
+        out << "Artist,Streams,Daily,As lead,Solo,As feature\n";
+        for (int i = 0; i < 70000; ++i) {
+            int streams = (i % 11 == 0) ? 0 : 1 + (i * 7919) % 5000;
+            int solo = (i % 22 == 0) ? 0 : (int)((long long)i * 104729 % 3000);
+            out << "A" << i << ',' << streams << ',' << ((i * 31) % 97) / 10.0 << ','
+                << (i * 13) % 2000 << ',' << solo << ',' << (i * 17) % 100 << '\n';
+        }
+    }
+    SpotifyDataset data;
+    std::ostringstream log;
+    CHECK(data.loadFromCSV(CSV, log));
+    std::remove(CSV);
+    CHECK(data.size() == 70000);
+
+    std::vector<Row> rows(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        rows[i] = { data.getAttribute(Attribute::Streams)[i], data.getAttribute(Attribute::Daily)[i],
+                    data.getAttribute(Attribute::AsLead)[i], data.getAttribute(Attribute::Solo)[i],
+                    data.getAttribute(Attribute::AsFeature)[i] };
+    }
+
+    using K = Query::AggKind;
+    Fn streams = [](const Row& r) { return r.streams; };
+    Fn daily = [](const Row& r) { return r.daily; };
+    Fn solo = [](const Row& r) { return r.solo; };
+    Fn ratio = [](const Row& r) { return r.solo / r.streams; };
+
+    // --- '(' qui ouvre une expression : la comparaison réussit sans retour arrière ---
+    std::string q = "select count(), sum(solo), mean(streams), min(daily), max(daily), variance(solo), stddev(solo) "
+                    "where (solo+1)/streams > 0.5";
+    compare(runQuery(data, q),
+            naive(rows, [](const Row& r) { return (r.solo + 1) / r.streams > 0.5; },
+                  { {K::Count, {}}, {K::Sum, solo}, {K::Mean, streams}, {K::Min, daily}, {K::Max, daily},
+                    {K::Variance, solo}, {K::Stddev, solo} }), q);
+
+    // --- '(' qui ouvre un prédicat : retour arrière puis parseOr ---
+    q = "select count(), sum(streams), mean(daily) where (solo > 1000 or daily < 1) and not (asfeature >= 50)";
+    compare(runQuery(data, q),
+            naive(rows, [](const Row& r) { return (r.solo > 1000 || r.daily < 1) && !(r.asfeature >= 50); },
+                  { {K::Count, {}}, {K::Sum, streams}, {K::Mean, daily} }), q);
+
+    q = "select count(), mean(solo) where ((solo)) > 10 and not not (streams <= 2500 or (aslead+1) < 100)";
+    compare(runQuery(data, q),
+            naive(rows, [](const Row& r) { return r.solo > 10 && (r.streams <= 2500 || r.aslead + 1 < 100); },
+                  { {K::Count, {}}, {K::Mean, solo} }), q);
+
+    // --- NaN et ±inf : comparaisons IEEE, valeurs non finies hors des agrégats ---
+    q = "select count(), mean(solo/streams), max(solo/streams) where solo/streams < 0.5";
+    compare(runQuery(data, q),
+            naive(rows, [](const Row& r) { return r.solo / r.streams < 0.5; },
+                  { {K::Count, {}}, {K::Mean, ratio}, {K::Max, ratio} }), q);
+
+    q = "select count(), sum(solo/streams) where not (solo/streams < 0.5)";
+    compare(runQuery(data, q),
+            naive(rows, [](const Row& r) { return !(r.solo / r.streams < 0.5); },
+                  { {K::Count, {}}, {K::Sum, ratio} }), q);
+
+    q = "select count() where solo/streams != 1";
+    compare(runQuery(data, q), naive(rows, [](const Row& r) { return r.solo / r.streams != 1; }, { {K::Count, {}} }), q);
+
+    q = "select count() where solo/streams == solo/streams";
+    Query::Result selfEq = runQuery(data, q);
+    compare(selfEq, naive(rows, [](const Row& r) { return r.solo / r.streams == r.solo / r.streams; },
+                          { {K::Count, {}} }), q);
+    CHECK(selfEq.selected == 70000 - 70000 / 22 - 1); // lignes NaN (i multiple de 22) exclues
+
+    // --- bucket() : le max tombe exactement sur la borne haute, rangé dans la dernière classe ---
+    q = "select count(), sum(daily), min(streams), max(streams) group by bucket(streams, 4)";
+    Query::Result byStreams = runQuery(data, q);
+    compare(byStreams, naive(rows, Pred(), { {K::Count, {}}, {K::Sum, daily}, {K::Min, streams}, {K::Max, streams} },
+                             streams, 4), q);
+    if (byStreams.groups.size() == 4) CHECK(byStreams.groups[3].values[3] == 5000.0);
+
+    q = "select count(), mean(daily) where streams > 0 group by bucket(daily, 7)";
+    compare(runQuery(data, q),
+            naive(rows, [](const Row& r) { return r.streams > 0; }, { {K::Count, {}}, {K::Mean, daily} }, daily, 7), q);
+
+    // Toutes les clés égales : largeur nulle, tout dans la première classe
+    q = "select count(), mean(solo) where daily == 0 group by bucket(daily, 3)";
+    compare(runQuery(data, q),
+            naive(rows, [](const Row& r) { return r.daily == 0; }, { {K::Count, {}}, {K::Mean, solo} }, daily, 3), q);
+
+    // --- clé de groupe non finie : ligne sélectionnée mais comptée dans aucun groupe ---
+    q = "select count(), mean(daily) group by bucket(solo/streams, 5)";
+    Query::Result byRatio = runQuery(data, q);
+    compare(byRatio, naive(rows, Pred(), { {K::Count, {}}, {K::Mean, daily} }, ratio, 5), q);
+    size_t grouped = 0;
+    for (const Query::Group& g : byRatio.groups) grouped += (size_t)g.values[0];
+    CHECK(byRatio.selected == 70000);
+    CHECK(grouped == 70000 - (70000 + 10) / 11); // lignes streams == 0 (NaN ou +inf) exclues
+
+    // Aucune clé finie : aucun groupe
+    q = "select count() where streams == 0 group by bucket(solo/streams, 3)";
+    Query::Result none = runQuery(data, q);
+    compare(none, naive(rows, [](const Row& r) { return r.streams == 0; }, { {K::Count, {}} }, ratio, 3), q);
+    CHECK(none.groups.empty());
+
+    return testResult("QueryTest");
+}
@@ -0,0 +1,168 @@
+// Snapshot binaire (<csv>.snap) : aller-retour exact, puis refus d'un fichier
+// corrompu (checksum, version, id de nom hors bornes) ou périmé (taille, date du CSV).
+#include "../src/SpotifyDataset.h"
+#include "Check.h"
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+
+namespace {
+
+const char* CSV = "snapshot_test.csv";
+const char* SNAP = "snapshot_test.csv.snap";
+const char* COPY = "snapshot_test_copy.snap";
+
+// Disposition de l'en-tête (voir SpotifyDataset.cpp, "Snapshot binaire", version 2)
+const size_t VERSION_AT = 8;
+const size_t NAME_IDS_OFFSET_AT = 80;
+const size_t HEADER_SIZE = 128;
+const size_t CHECKSUM_AT = 120;
+
+std::string readFile(const std::string& file) {
+    std::ifstream in(file, std::ios::binary);
+    std::ostringstream oss;
+    oss << in.rdbuf();
+    return oss.str();
+}
+
+void writeFile(const std::string& file, const std::string& bytes) {
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), (std::streamsize)bytes.size());
+}
+
+template <class T> T readAt(const std::string& bytes, size_t at) {
+    T v;
+    std::memcpy(&v, bytes.data() + at, sizeof(T));
+    return v;
+}
+
+template <class T> void writeAt(std::string& bytes, size_t at, T v) {
+    std::memcpy(&bytes[at], &v, sizeof(T));
+}
+
+// Même checksum que le format (FNV-1a par mots de 64 bits) : sert à fabriquer
+// un fichier corrompu dont le checksum reste valide
+uint64_t checksum(const char* data, size_t n) {
+    uint64_t h = 1469598103934665603ULL;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h = (h ^ w) * 1099511628211ULL;
+    }
+    for (; i < n; ++i) h = (h ^ (unsigned char)data[i]) * 1099511628211ULL;
+    return h;
+}
+
+bool loadCopy(const std::string& bytes) {
+    writeFile(COPY, bytes);
+    SpotifyDataset d;
+    return d.loadSnapshot(COPY, CSV);
+}
+
+} // namespace
+
+int main() {
+    {
+        std::ofstream out(CSV);
+        out << "Artist,Streams,Daily,As lead,Solo,As feature\n"
+            << "Taylor Swift,\"85,041.3\",85.793,\"55,566.7\",\"29,397.6\",\"2,292.4\"\n"
+            << "Drake,\"84,700.5\",50.775,\"57,252.6\",\"27,359.9\",\"27,788.7\"\n"
+            << "\"Tyler, The Creator\",1234.5,0.5,1000,800,234.5\n"
+            << "Drake,10,1,5,5,5\n"        // doublon : findArtist garde la première ligne
+            << "Sigur Rós,0.25,0,0.25,0.25,0\n";
+    }
+    SpotifyDataset original;
+    std::ostringstream log;
+    CHECK(original.loadFromCSV(CSV, log));
+    CHECK(original.size() == 5);
+
+    // --- Aller-retour ---
+    CHECK(original.saveSnapshot(SNAP, CSV));
+    SpotifyDataset loaded;
+    CHECK(loaded.loadSnapshot(SNAP, CSV));
+    CHECK(loaded.size() == original.size());
+    for (int a = 0; a < NB_ATTRIBUTES; ++a) {
+        ColumnView x = original.getAttribute((Attribute)a), y = loaded.getAttribute((Attribute)a);
+        CHECK(x.size() == y.size());
+        for (size_t i = 0; i < x.size() && i < y.size(); ++i) CHECK(x[i] == y[i]);
+    }
+    for (size_t i = 0; i < original.size() && i < loaded.size(); ++i) {
+        CHECK(loaded.getName(i) == original.getName(i));
+        CHECK(loaded.getNameId(i) == original.getNameId(i));
+        CHECK(loaded.findArtist(original.getName(i)) == original.findArtist(original.getName(i)));
+    }
+    CHECK(loaded.findArtist("Drake") == 1);
+    CHECK(loaded.findArtist("Tyler, The Creator") == 2);
+    CHECK(loaded.findArtist("Inconnu") == -1);
+    CHECK_CLOSE(loaded.aggregates().mean((size_t)Attribute::Streams),
+                original.aggregates().mean((size_t)Attribute::Streams), 1e-12);
+
+    const std::string good = readFile(SNAP);
+    CHECK(good.size() > HEADER_SIZE);
+    CHECK(loadCopy(good));
+
+    // --- Checksum : un octet du corps modifié ---
+    {
+        std::string bad = good;
+        bad[HEADER_SIZE] ^= 0x01;
+        CHECK(!loadCopy(bad));
+    }
+    // --- Version inconnue ---
+    {
+        std::string bad = good;
+        writeAt<uint32_t>(bad, VERSION_AT, readAt<uint32_t>(bad, VERSION_AT) + 1);
+        CHECK(!loadCopy(bad));
+    }
+    // --- Id de nom >= nombre de noms, checksum recalculé pour passer ce contrôle ---
+    {
+        std::string bad = good;
+        uint64_t idsAt = readAt<uint64_t>(bad, NAME_IDS_OFFSET_AT);
+        writeAt<uint32_t>(bad, (size_t)idsAt, 1000u);
+        writeAt<uint64_t>(bad, CHECKSUM_AT, checksum(bad.data() + HEADER_SIZE, bad.size() - HEADER_SIZE));
+        CHECK(!loadCopy(bad));
+        // Contrôle du test lui-même : le même recalcul sans corruption est accepté
+        std::string same = good;
+        writeAt<uint64_t>(same, CHECKSUM_AT, checksum(same.data() + HEADER_SIZE, same.size() - HEADER_SIZE));
+        CHECK(loadCopy(same));
+    }
+    // --- Snapshot tronqué ---
+    CHECK(!loadCopy(good.substr(0, good.size() / 2)));
+
+    // --- CSV modifié : date différente, même taille ---
+    {
+        auto t = std::filesystem::last_write_time(CSV);
+        std::filesystem::last_write_time(CSV, t + std::chrono::seconds(10));
+        SpotifyDataset d;
+        CHECK(!d.loadSnapshot(SNAP, CSV));
+        std::filesystem::last_write_time(CSV, t);
+        CHECK(d.loadSnapshot(SNAP, CSV));
+    }
+    // --- CSV modifié : taille différente, même date ---
+    {
+        auto t = std::filesystem::last_write_time(CSV);
+        std::string csv = readFile(CSV);
+        writeFile(CSV, csv + "Nouveau,1,1,1,1,1\n");
+        std::filesystem::last_write_time(CSV, t);
+        SpotifyDataset d;
+        CHECK(!d.loadSnapshot(SNAP, CSV));
+        // load() retombe sur le CSV et réécrit un snapshot à jour
+        std::ostringstream l;
+        CHECK(d.load(CSV, l));
+        CHECK(d.size() == 6);
+        SpotifyDataset again;
+        CHECK(again.loadSnapshot(SNAP, CSV));
+        CHECK(again.size() == 6);
+    }
+
+    std::remove(CSV);
+    std::remove(SNAP);
+    std::remove(COPY);
+    return testResult("SnapshotTest");
+}
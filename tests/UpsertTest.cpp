@@ -0,0 +1,108 @@
+// Ajout incrémental (upsertFromCSV) : les lignes et les agrégats obtenus doivent être
+// ceux d'un chargement complet du fichier fusionné, y compris quand la ligne
+// remplacée dominait les moyennes (cas où des retraits successifs dériveraient).
+#include "../src/SpotifyDataset.h"
+#include "Check.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace {
+
+const char* BASE = "upsert_test_base.csv";
+const char* DELTA = "upsert_test_delta.csv";
+const char* MERGED = "upsert_test_merged.csv";
+const char* HEADER = "Artist,Streams,Daily,As lead,Solo,As feature\n";
+
+struct Row {
+    std::string name;
+    double v[NB_ATTRIBUTES];
+};
+
+Row makeRow(const std::string& name, int seed) {
+    Row r;
+    r.name = name;
+    for (int a = 0; a < NB_ATTRIBUTES; ++a) r.v[a] = (double)((seed * 37 + a * 101) % 1000) + 0.5;
+    return r;
+}
+
+void writeCSV(const char* file, const std::vector<Row>& rows) {
+    std::ofstream out(file);
+    out << HEADER;
+    for (const Row& r : rows) {
+        out << r.name;
+        for (int a = 0; a < NB_ATTRIBUTES; ++a) out << ',' << r.v[a];
+        out << '\n';
+    }
+}
+
+} // namespace
+
+int main() {
+    std::vector<Row> base, delta;
+    for (int i = 0; i < 200; ++i) base.push_back(makeRow("A" + std::to_string(i), i));
+    base[0].v[(int)Attribute::Streams] = 1e9; // domine la moyenne et la variance de streams
+
+    std::vector<Row> merged = base;
+    for (int i = 0; i < 200; i += 5) {       // mises à jour, dont la ligne dominante
+        Row r = makeRow("A" + std::to_string(i), i + 500);
+        delta.push_back(r);
+        merged[i] = r;
+    }
+    for (int i = 0; i < 10; ++i) {           // nouveaux artistes, ajoutés en fin
+        Row r = makeRow("B" + std::to_string(i), i + 900);
+        delta.push_back(r);
+        merged.push_back(r);
+    }
+    writeCSV(BASE, base);
+    writeCSV(DELTA, delta);
+    writeCSV(MERGED, merged);
+
+    std::ostringstream log;
+    SpotifyDataset data, reference;
+    CHECK(data.loadFromCSV(BASE, log));
+    CHECK(reference.loadFromCSV(MERGED, log));
+    uint64_t before = data.generation();
+
+    SpotifyDataset::UpsertStats stats;
+    CHECK(data.upsertFromCSV(DELTA, log, stats));
+    CHECK(stats.updated == 40);
+    CHECK(stats.inserted == 10);
+    CHECK(data.generation() != before);
+
+    // Mêmes lignes, dans le même ordre
+    CHECK(data.size() == reference.size());
+    if (data.size() == reference.size()) {
+        for (size_t i = 0; i < data.size(); ++i) CHECK(data.getName(i) == reference.getName(i));
+        for (int a = 0; a < NB_ATTRIBUTES; ++a) {
+            ColumnView x = data.getAttribute((Attribute)a), y = reference.getAttribute((Attribute)a);
+            for (size_t i = 0; i < x.size(); ++i) CHECK(x[i] == y[i]);
+        }
+    }
+
+    // Mêmes agrégats qu'un recalcul complet
+    const CoMomentMatrix& m = data.aggregates();
+    const CoMomentMatrix& r = reference.aggregates();
+    CHECK(m.count() == r.count());
+    for (size_t i = 0; i < NB_ATTRIBUTES; ++i) {
+        CHECK_CLOSE(m.mean(i), r.mean(i), 1e-12);
+        for (size_t j = 0; j < NB_ATTRIBUTES; ++j) {
+            CHECK_CLOSE(m.covariance(i, j), r.covariance(i, j), 1e-12);
+            CHECK_CLOSE(m.pearson(i, j), r.pearson(i, j), 1e-12);
+        }
+    }
+
+    // Fichier absent : échec, données et génération inchangées
+    uint64_t gen = data.generation();
+    SpotifyDataset::UpsertStats none;
+    CHECK(!data.upsertFromCSV("upsert_test_absent.csv", log, none));
+    CHECK(none.inserted == 0 && none.updated == 0);
+    CHECK(data.generation() == gen);
+
+    std::remove(BASE);
+    std::remove(DELTA);
+    std::remove(MERGED);
+    return testResult("UpsertTest");
+}
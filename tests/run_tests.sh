@@ -0,0 +1,24 @@
+#!/bin/sh
+# Compile et lance tous les tests tests/*Test.cpp (POSIX, depuis la racine ou depuis tests/)
+cd "$(dirname "$0")" || exit 1
+CXX="g++ -std=c++17 -O2 -Wall -Wextra -pthread"
+OBJ=$(mktemp -d) || exit 1
+trap 'rm -rf "$OBJ"' EXIT
+
+# Sources du programme compilées une fois (sans main.cpp ni client.cpp)
+for src in ../src/*.cpp; do
+    case "$src" in */main.cpp|*/client.cpp) continue ;; esac
+    $CXX -c "$src" -o "$OBJ/$(basename "$src" .cpp).o" || exit 1
+done
+
+status=0
+for test in *Test.cpp; do
+    name=${test%.cpp}
+    if ! $CXX -o "$name" "$test" "$OBJ"/*.o; then
+        echo "$name : echec de compilation"
+        status=1
+        continue
+    fi
+    ./"$name" || status=1
+done
+exit $status